@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::write_columns / columnar_file.
+
+Writes records of 17 data members (112 bytes) to a file as an array of structures (one fwrite of
+the std::vector) and in the columnar format (from a std::vector and from a soa_vector), and reads
+the sum of one data member back: by reading the whole array-of-structures file, and by mapping the
+columnar file and summing its column. The files are in the page cache after writing, i.e. the
+reading times show the cost of copying 14 times the data rather than the cost of disk I/O.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/columnar_file.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Sample
+{
+  std::uint64_t timestamp;
+  std::uint32_t channel, flags;
+  double value, error, gain, offset;
+  double temperature, pressure, voltage, current;
+  float x, y, z, w;
+  std::uint64_t run, sequence;
+  VIR_MAKE_REFLECTABLE(Sample, timestamp, channel, flags, value, error, gain, offset, temperature,
+                       pressure, voltage, current, x, y, z, w, run, sequence);
+};
+
+template <typename F>
+  double
+  measure(F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    return t / COUNT;
+  }
+
+int
+main(int, char** argv)
+{
+  const std::string aos_path = std::string(argv[1]) + "/samples.aos";
+  const std::string col_path = std::string(argv[1]) + "/samples.col";
+  const std::string soa_path = std::string(argv[1]) + "/samples-soa.col";
+  std::vector<Sample> samples(COUNT);
+  vir::refl::soa_vector<Sample> soa;
+  for (int i = 0; i < COUNT; ++i)
+    {
+      samples[i] = {std::uint64_t(i) * 1000, std::uint32_t(i % 64), 0, i * 0.5, 0.1, 1., 0.,
+                    20., 1013., 5., 0.1, 1.f, 2.f, 3.f, 4.f, 7, std::uint64_t(i)};
+      soa.push_back(samples[i]);
+    }
+
+  const double write_aos = measure([&] {
+    std::FILE* f = std::fopen(aos_path.c_str(), "wb");
+    std::fwrite(samples.data(), sizeof(Sample), samples.size(), f);
+    std::fclose(f);
+  });
+  const double write_vector = measure([&] {
+    vir::refl::write_columns(col_path.c_str(), samples);
+  });
+  const double write_soa = measure([&] {
+    vir::refl::write_columns(soa_path.c_str(), soa);
+  });
+  std::printf("write aos %f\nwrite columns(vector) %f\nwrite columns(soa_vector) %f\n",
+              write_aos, write_vector, write_soa);
+
+  double sum_aos = 0, sum_col = 0;
+  const double read_aos = measure([&] {
+    std::vector<Sample> v(COUNT);
+    std::FILE* f = std::fopen(aos_path.c_str(), "rb");
+    const std::size_t n = std::fread(v.data(), sizeof(Sample), v.size(), f);
+    std::fclose(f);
+    sum_aos = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      sum_aos += v[i].value;
+  });
+  const double read_col = measure([&] {
+    const vir::refl::columnar_file<Sample> file(col_path.c_str());
+    sum_col = 0;
+    for (double x : file.column<"value">())
+      sum_col += x;
+  });
+  if (sum_aos != sum_col)
+    std::puts("mismatch");
+  std::printf("read aos %f\nread columnar_file %f\n", read_aos, read_col);
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=500000,
+                        help="number of records")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="columnar.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "columnar.cpp")
+        exe = os.path.join(tmp, "columnar")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe, tmp], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                if line == "mismatch":
+                    sys.exit(f"{cxx}: the sums of the two files differ")
+                method, ns = line.rsplit(" ", 1)
+                results.append({"compiler": cxx, "method": method,
+                                "ns_per_record": round(float(ns), 2)})
+                print(f"{cxx:>12} {method:>26}: {float(ns):7.2f} ns per record", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
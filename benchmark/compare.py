@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::compare_by / equal_by.
+
+Sorts and deduplicates an array of records by three key data members (std::sort followed by
+std::unique) using compare_by / equal_by with the key's index array, a hand-written std::tie
+comparison of the key, and the defaulted operator<=> / operator== over all data members.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-compare.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct Record
+{
+  std::uint32_t run, lumi;
+  std::uint64_t event;
+  float energy, time;
+  double x, y, z;
+  std::string source;
+  VIR_MAKE_REFLECTABLE(Record, run, lumi, event, energy, time, x, y, z, source);
+  friend auto operator<=>(const Record&, const Record&) = default;
+};
+
+constexpr std::array<std::size_t, 3> key
+  = {vir::refl::data_member_index<Record, "run">, vir::refl::data_member_index<Record, "lumi">,
+     vir::refl::data_member_index<Record, "event">};
+
+template <typename Less, typename Equal>
+  [[gnu::noinline]] void
+  run(const char* method, const std::vector<Record>& input, Less less, Equal equal)
+  {
+    double t = 1e300;
+    std::size_t unique = 0;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        std::vector<Record> v = input;
+        auto t0 = std::chrono::steady_clock::now();
+        std::sort(v.begin(), v.end(), less);
+        unique = std::unique(v.begin(), v.end(), equal) - v.begin();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    std::printf("%s %zu %f\n", method, unique, t / input.size());
+  }
+
+int
+main()
+{
+  std::vector<Record> input(COUNT);
+  std::uint64_t state = 1;
+  for (Record& r : input)
+    {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      const std::uint64_t x = state >> 33;
+      // ~50% duplicate keys, with differing payload
+      r = {std::uint32_t(x % 4), std::uint32_t(x / 4 % 100), x / 400 % (COUNT / 800 + 1),
+           float(x % 7), 1.f, 0.5, double(x % 3), 0., "detector"};
+    }
+  run("vir", input,
+      [](const Record& a, const Record& b) { return vir::refl::compare_by<key>(a, b) < 0; },
+      [](const Record& a, const Record& b) { return vir::refl::equal_by<key>(a, b); });
+  run("std::tie", input,
+      [](const Record& a, const Record& b) {
+        return std::tie(a.run, a.lumi, a.event) < std::tie(b.run, b.lumi, b.event);
+      },
+      [](const Record& a, const Record& b) {
+        return std::tie(a.run, a.lumi, a.event) == std::tie(b.run, b.lumi, b.event);
+      });
+  run("defaulted<=>", input, std::less<>(), std::equal_to<>());
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=1000000,
+                        help="number of records")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="compare.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "compare.cpp")
+        exe = os.path.join(tmp, "compare")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                method, unique, ns = line.split()
+                results.append({"compiler": cxx, "method": method, "unique": int(unique),
+                                "ns_per_record": round(float(ns), 2)})
+                print(f"{cxx:>12} {method:>12}: {float(ns):7.2f} ns per record "
+                      f"({unique} unique)", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,322 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Compile-time and compiler memory benchmark for vir-reflect-light.
+
+Generates translation units with reflectable structs of varying member count and
+inheritance depth, compiles every TU with each requested compiler, and records
+wall time, compiler-reported front-end time, and peak RSS into a JSON file.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+MEMBER_TYPES = ["int", "float", "double", "char", "long", "short", "unsigned", "bool"]
+
+FACILITIES = {}
+
+# facilities that do not need the reflectable classes in their TU
+WITHOUT_CLASSES = set()
+
+
+def facility(fun):
+    FACILITIES[fun.__name__] = fun
+    return fun
+
+
+def facility_without_classes(fun):
+    WITHOUT_CLASSES.add(fun.__name__)
+    return facility(fun)
+
+
+class Hierarchy:
+    """A chain of `depth` reflectable classes with `members` data members each.
+
+    Class `L0` is the root, `L<depth-1>` the most derived class, which is exposed
+    as `T`.
+    """
+
+    def __init__(self, members, depth, explicit_base=False):
+        self.members = members
+        self.depth = depth
+        self.explicit_base = explicit_base
+
+    def member_name(self, level, i):
+        return f"m{level}_{i}"
+
+    def member_type(self, level, i):
+        return MEMBER_TYPES[(level * self.members + i) % len(MEMBER_TYPES)]
+
+    def all_members(self):
+        for level in range(self.depth):
+            for i in range(self.members):
+                yield self.member_name(level, i), self.member_type(level, i)
+
+    @property
+    def count(self):
+        return self.members * self.depth
+
+    def reflect_macro(self, level):
+        names = ", ".join(self.member_name(level, i) for i in range(self.members))
+        if self.explicit_base:
+            base = f"L{level - 1}" if level > 0 else "void"
+            return f"VIR_MAKE_REFLECTABLE_WITH_BASE(L{level}, {base}, {names});"
+        return f"VIR_MAKE_REFLECTABLE(L{level}, {names});"
+
+    def source(self):
+        out = []
+        for level in range(self.depth):
+            base = f" : L{level - 1}" if level > 0 else ""
+            out.append(f"struct L{level}{base}\n{{")
+            for i in range(self.members):
+                out.append(f"  {self.member_type(level, i)} {self.member_name(level, i)};")
+            out.append(f"  {self.reflect_macro(level)}\n}};\n")
+        out.append(f"using T = L{self.depth - 1};\n")
+        return "\n".join(out)
+
+
+@facility
+def none(h):
+    return ""
+
+
+@facility
+def data_member_count(h):
+    return f"static_assert(vir::refl::data_member_count<T> == {h.count});\n"
+
+
+@facility
+def data_member_name(h):
+    return "".join(f'static_assert(vir::refl::data_member_name<T, {i}> == "{name}");\n'
+                   for i, (name, _) in enumerate(h.all_members()))
+
+
+@facility
+def data_member_index(h):
+    return "".join(f'static_assert(vir::refl::data_member_index<T, "{name}"> == {i});\n'
+                   for i, (name, _) in enumerate(h.all_members()))
+
+
+@facility
+def data_member_type(h):
+    return "".join(f"static_assert(std::same_as<vir::refl::data_member_type<T, {i}>, {t}>);\n"
+                   for i, (_, t) in enumerate(h.all_members()))
+
+
+@facility
+def all_data_members(h):
+    return ("auto\nuse_all_data_members(T& obj)\n{ return vir::refl::all_data_members(obj); }\n\n"
+            f"static_assert(decltype(use_all_data_members(std::declval<T&>()))::size == {h.count});\n")
+
+
+@facility
+def find_data_members(h):
+    ints = sum(1 for _, t in h.all_members() if t == "int")
+    fps = sum(1 for _, t in h.all_members() if t in ("float", "double"))
+    return ("template <typename U, std::size_t Idx>\n"
+            "  using is_int = std::is_same<vir::refl::data_member_type<U, Idx>, int>;\n\n"
+            f"static_assert(vir::refl::find_data_members<T, is_int>.size() == {ints});\n"
+            "static_assert(vir::refl::find_data_members_by_type<T, std::is_floating_point>.size()"
+            f" == {fps});\n")
+
+
+@facility
+def base_type(h):
+    expected = f"L{h.depth - 2}" if h.depth > 1 else "void"
+    return f"static_assert(std::same_as<vir::refl::base_type<T>, {expected}>);\n"
+
+
+@facility_without_classes
+def simple_tuple(h):
+    types = ", ".join(t for _, t in h.all_members())
+    return (f"using Tuple = vir::simple_tuple<{types}>;\n\n"
+            "constexpr auto\nuse_simple_tuple(Tuple& t)\n{\n  return\n"
+            + " +\n".join(f"    get<{i}>(t)" for i in range(h.count)) + ";\n}\n\n"
+            + "".join(f"static_assert(std::same_as<Tuple::type_at<{i}>, {t}>);\n"
+                      for i, (_, t) in enumerate(h.all_members())))
+
+
+# The facility snippets use a few std names, which importers of the module don't get.
+MODULE_PRELUDE = ("#include <vir/reflect-light-macros.h>\n#include <concepts>\n#include <utility>\n"
+                  "import vir.reflect_light;\n\n")
+
+
+def generate(h, fac, module=False):
+    classes = "" if fac in WITHOUT_CLASSES else h.source() + "\n"
+    prelude = MODULE_PRELUDE if module else "#include <vir/reflect-light.h>\n\n"
+    return prelude + classes + FACILITIES[fac](h)
+
+
+def build_module(cxx, family, cxxflags, tmp, log):
+    """Compiles the vir.reflect_light BMI into `tmp` and returns the flags for importing it.
+
+    GCC writes the BMI to gcm.cache/ in its working directory, which therefore must be `tmp` for
+    every compiler invocation.
+    """
+    cppm = os.path.join(SRCDIR, "vir", "reflect-light.cppm")
+    if family == "gcc":
+        cmd = [cxx] + cxxflags + ["-fmodules-ts", "-I", SRCDIR, "-x", "c++", "-c", cppm,
+                                  "-o", os.path.join(tmp, "module.o")]
+        flags = ["-fmodules-ts"]
+    else:
+        pcm = os.path.join(tmp, "vir.reflect_light.pcm")
+        cmd = [cxx] + cxxflags + ["-I", SRCDIR, "--precompile", "-x", "c++-module", cppm,
+                                  "-o", pcm]
+        flags = [f"-fmodule-file=vir.reflect_light={pcm}"]
+    rc, wall, _, stderr = run_compiler(cmd, log, cwd=tmp)
+    if rc != 0:
+        sys.exit(f"building the module with {cxx} failed:\n{stderr}")
+    print(f"{cxx:>12} built vir.reflect_light in {wall:.3f} s", flush=True)
+    return flags
+
+
+def run_compiler(cmd, log, cwd=None):
+    """Runs `cmd` and returns (returncode, wall seconds, peak RSS in KiB, stderr).
+
+    stderr goes through the file `log`: the peak RSS of the child starts out at the RSS of this
+    process, which therefore must not grow by buffering (possibly huge) compiler output.
+    """
+    with open(log, "w") as err:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=err, cwd=cwd)
+        _, status, rusage = os.wait4(proc.pid, 0)
+        wall = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    stderr = []
+    with open(log, errors="replace") as f:
+        for line in f:
+            if "TOTAL" in line or ("error" in line and len(stderr) < 10):
+                stderr.append(line)
+    return proc.returncode, wall, rusage.ru_maxrss, "".join(stderr)
+
+
+def compiler_info(cxx):
+    version = subprocess.run([cxx, "--version"], capture_output=True, text=True).stdout
+    first = version.splitlines()[0] if version else cxx
+    family = "clang" if "clang" in version.lower() else "gcc"
+    return family, first
+
+
+def frontend_seconds(family, stderr, trace_file):
+    """Extracts the compiler's own total time from -ftime-report / -ftime-trace output."""
+    if family == "gcc":
+        # " TOTAL : <usr> <sys> <wall> <GGC memory>"
+        m = re.search(r"^ TOTAL\s*:\s*[0-9.]+\s+[0-9.]+\s+([0-9.]+)", stderr, re.MULTILINE)
+        return float(m.group(1)) if m else None
+    try:
+        with open(trace_file) as f:
+            events = json.load(f)["traceEvents"]
+    except (OSError, ValueError, KeyError):
+        return None
+    for e in events:
+        if e.get("name") == "Total ExecuteCompiler":
+            return e["dur"] / 1e6
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--facilities", nargs="+", choices=sorted(FACILITIES),
+                        default=list(FACILITIES))
+    parser.add_argument("--members", nargs="+", type=int,
+                        default=[1, 2, 4, 8, 16, 32, 64, 128, 256],
+                        help="member counts of the single-class sweep")
+    parser.add_argument("--depths", nargs="+", type=int, default=[1, 2, 4, 8, 16, 32],
+                        help="inheritance depths of the hierarchy sweep")
+    parser.add_argument("--members-per-level", type=int, default=4,
+                        help="data members per class in the hierarchy sweep")
+    parser.add_argument("--repeat", type=int, default=1,
+                        help="compile every TU this often and keep the fastest run")
+    parser.add_argument("-E", "--preprocess-only", action="store_true",
+                        help="only run the preprocessor instead of the front end")
+    parser.add_argument("--explicit-base", action="store_true",
+                        help="name the base class via VIR_MAKE_REFLECTABLE_WITH_BASE")
+    parser.add_argument("--module", action="store_true",
+                        help="import the vir.reflect_light module instead of including the header")
+    parser.add_argument("--no-frontend-time", action="store_true",
+                        help="don't ask the compiler for its own timings (they add overhead)")
+    parser.add_argument("-o", "--output", default="compile-time.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    configs = [(m, 1) for m in args.members]
+    configs += [(args.members_per_level, d) for d in args.depths if d > 1]
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "bench.cpp")
+        trace = os.path.join(tmp, "bench.json")
+        log = os.path.join(tmp, "stderr.txt")
+        for cxx in compilers:
+            family, _ = compiler_info(cxx)
+            timing = ["-ftime-report"] if family == "gcc" else [f"-ftime-trace={trace}"]
+            if args.no_frontend_time or (args.module and family == "gcc"):
+                timing = []  # GCC 12 ICEs on -ftime-report when importing modules
+            mode = "-E" if args.preprocess_only else "-fsyntax-only"
+            module_flags = []
+            if args.module:
+                module_flags = build_module(cxx, family, args.cxxflags.split(), tmp, log)
+            cmd = ([cxx] + args.cxxflags.split() + module_flags
+                   + ["-I", SRCDIR, mode] + timing + [src])
+            for fac in args.facilities:
+                for members, depth in configs:
+                    h = Hierarchy(members, depth, args.explicit_base)
+                    with open(src, "w") as f:
+                        f.write(generate(h, fac, args.module))
+                    best = None
+                    for _ in range(args.repeat):
+                        rc, wall, rss, stderr = run_compiler(cmd, log, cwd=tmp)
+                        run = {"wall_s": round(wall, 4), "peak_rss_kib": rss,
+                               "frontend_s": frontend_seconds(family, stderr, trace)}
+                        if rc != 0:
+                            run["error"] = next((line for line in stderr.splitlines()
+                                                 if "error" in line), "failed")[:200]
+                        if best is None or wall < best["wall_s"]:
+                            best = run
+                    record = {"compiler": cxx, "facility": fac, "members": h.count,
+                              "members_per_class": members, "depth": depth, **best}
+                    results.append(record)
+                    status = "FAILED" if "error" in best else f"{best['peak_rss_kib']:8} KiB"
+                    print(f"{cxx:>12} {fac:>18} {h.count:4} members, depth {depth:2}: "
+                          f"{best['wall_s']:7.3f} s {status}", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({
+            "date": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+            "commit": subprocess.run(["git", "-C", SRCDIR, "rev-parse", "HEAD"],
+                                     capture_output=True, text=True).stdout.strip(),
+            "cxxflags": args.cxxflags,
+            "preprocess_only": args.preprocess_only,
+            "explicit_base": args.explicit_base,
+            "module": args.module,
+            "compilers": {cxx: compiler_info(cxx)[1] for cxx in compilers},
+            "results": results,
+        }, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
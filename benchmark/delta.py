@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::serialize_delta / deserialize_delta.
+
+Replicates a state struct with 80 data members (double, float, and int) from a sender to a
+receiver, where every update changes 4 data members: as full snapshots (serialize / deserialize)
+and as deltas (serialize_delta(prev, state) including the diff, deserialize_delta). Reports the
+time and the number of bytes per update.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-delta.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+struct State
+{
+  @MEMBERS@
+};
+
+template <typename F>
+  double
+  measure(F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    return t / COUNT;
+  }
+
+// changes 4 data members of state (the same sequence for every method)
+void
+update(State& state, unsigned& rng)
+{
+  for (int k = 0; k < 4; ++k)
+    {
+      rng = rng * 1664525u + 1013904223u;
+      vir::refl::visit_data_member(state, (rng >> 8) % vir::refl::data_member_count<State>,
+                                   [](auto& x) { x += 1; });
+    }
+}
+
+int
+main()
+{
+  std::vector<std::byte> buffer(2 * vir::refl::serialized_size(State {}));
+  std::size_t bytes = 0;
+  bool same = true;
+
+  const double t_snapshot = measure([&] {
+    State sender {}, receiver {};
+    unsigned rng = 1;
+    bytes = 0;
+    for (int i = 0; i < COUNT; ++i)
+      {
+        update(sender, rng);
+        const std::size_t n = vir::refl::serialize(sender, buffer);
+        bytes += n;
+        vir::refl::deserialize(receiver, std::span(buffer).first(n));
+      }
+    same = vir::refl::diff(sender, receiver).none();
+  });
+  const std::size_t snapshot_bytes = bytes;
+  if (not same)
+    std::puts("mismatch");
+
+  const double t_delta = measure([&] {
+    State sender {}, prev {}, receiver {};
+    unsigned rng = 1;
+    bytes = 0;
+    for (int i = 0; i < COUNT; ++i)
+      {
+        update(sender, rng);
+        const std::size_t n = vir::refl::serialize_delta(prev, sender, buffer);
+        prev = sender;
+        bytes += n;
+        vir::refl::deserialize_delta(receiver, std::span(buffer).first(n));
+      }
+    same = vir::refl::diff(sender, receiver).none();
+  });
+  if (not same)
+    std::puts("mismatch");
+
+  std::printf("snapshot %f %f\ndelta %f %f\n", t_snapshot, double(snapshot_bytes) / COUNT,
+              t_delta, double(bytes) / COUNT);
+}
+"""
+
+
+def state_members():
+    """The 80 data members of State: 41 double, 26 float, and 13 int, interleaved."""
+    types = ["double", "float", "double", "int", "double", "float"] * 13 + ["double", "double"]
+    names = [f"m{i}" for i in range(len(types))]
+    decls = "".join(f"{t} {n};\n  " for t, n in zip(types, names))
+    return decls + f"VIR_MAKE_REFLECTABLE(State, {', '.join(names)});"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=1000000,
+                        help="number of updates")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="delta.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "delta.cpp")
+        exe = os.path.join(tmp, "delta")
+        with open(src, "w") as f:
+            f.write(SOURCE.replace("@MEMBERS@", state_members()))
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                if line == "mismatch":
+                    sys.exit(f"{cxx}: the receiver differs from the sender")
+                method, ns, size = line.split()
+                results.append({"compiler": cxx, "method": method,
+                                "ns_per_update": round(float(ns), 2),
+                                "bytes_per_update": round(float(size), 2)})
+                print(f"{cxx:>12} {method:>8}: {float(ns):7.2f} ns, {float(size):6.1f} bytes "
+                      "per update", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
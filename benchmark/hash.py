@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::hash.
+
+Hashes arrays of composite keys with vir::refl::hash and with a hand-written hash_combine chain
+over std::hash of every data member (boost style), and looks up all keys in a
+std::unordered_map using either hash function. Keys without padding are hashed over their bytes by
+vir::refl::hash; the key with a std::string member is hashed member-wise.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-hash.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 16 bytes, no padding
+struct Key
+{
+  std::uint32_t run, lumi;
+  std::uint64_t event;
+  VIR_MAKE_REFLECTABLE(Key, run, lumi, event);
+  friend bool operator==(const Key&, const Key&) = default;
+};
+
+// 64 bytes, no padding
+struct WideKey
+{
+  std::uint64_t a, b, c, d, e, f, g, h;
+  VIR_MAKE_REFLECTABLE(WideKey, a, b, c, d, e, f, g, h);
+  friend bool operator==(const WideKey&, const WideKey&) = default;
+};
+
+struct NamedKey
+{
+  std::string detector;
+  std::uint32_t channel;
+  std::uint16_t layer;
+  std::uint64_t event;
+  VIR_MAKE_REFLECTABLE(NamedKey, detector, channel, layer, event);
+  friend bool operator==(const NamedKey&, const NamedKey&) = default;
+};
+
+template <typename T>
+  inline void
+  hash_combine(std::size_t& seed, const T& x)
+  { seed ^= std::hash<T>()(x) + 0x9e3779b9 + (seed << 6) + (seed >> 2); }
+
+// the hand-written chains the library replaces
+struct manual_hasher
+{
+  std::size_t
+  operator()(const Key& k) const
+  {
+    std::size_t seed = 0;
+    hash_combine(seed, k.run);
+    hash_combine(seed, k.lumi);
+    hash_combine(seed, k.event);
+    return seed;
+  }
+
+  std::size_t
+  operator()(const WideKey& k) const
+  {
+    std::size_t seed = 0;
+    hash_combine(seed, k.a);
+    hash_combine(seed, k.b);
+    hash_combine(seed, k.c);
+    hash_combine(seed, k.d);
+    hash_combine(seed, k.e);
+    hash_combine(seed, k.f);
+    hash_combine(seed, k.g);
+    hash_combine(seed, k.h);
+    return seed;
+  }
+
+  std::size_t
+  operator()(const NamedKey& k) const
+  {
+    std::size_t seed = 0;
+    hash_combine(seed, k.detector);
+    hash_combine(seed, k.channel);
+    hash_combine(seed, k.layer);
+    hash_combine(seed, k.event);
+    return seed;
+  }
+};
+
+template <typename F>
+  double
+  measure(F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    return t / COUNT;
+  }
+
+template <typename H, typename K>
+  [[gnu::noinline]] void
+  run(const char* key, const char* method, const std::vector<K>& keys)
+  {
+    const H h {};
+    std::size_t sum = 0;
+    const double t_hash = measure([&] {
+      for (const K& k : keys)
+        sum += h(k);
+    });
+    std::unordered_map<K, int, H> map;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      map.emplace(keys[i], int(i));
+    // look up in a different order than inserted (a weak hash of sequential keys otherwise
+    // profits from sequential bucket access)
+    std::vector<const K*> order(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      order[i] = &keys[i * 7919 % keys.size()];
+    const double t_find = measure([&] {
+      for (const K* k : order)
+        sum += map.find(*k)->second;
+    });
+    if (sum == 1)
+      std::puts("");
+    std::printf("%s %s %f %f\n", key, method, t_hash, t_find);
+  }
+
+int
+main()
+{
+  std::vector<Key> keys(COUNT);
+  std::vector<WideKey> wide(COUNT);
+  std::vector<NamedKey> named(COUNT);
+  for (int i = 0; i < COUNT; ++i)
+    {
+      const std::uint64_t x = i;
+      keys[i] = {std::uint32_t(x % 7), std::uint32_t(x / 7 % 100), x};
+      wide[i] = {x, x % 3, 0, x * 7, 1, 2, x % 11, 3};
+      named[i] = {i % 2 ? "pixel-barrel" : "strip-endcap", std::uint32_t(x % 1000),
+                  std::uint16_t(x % 5), x};
+    }
+  run<vir::refl::hasher>("Key", "vir", keys);
+  run<manual_hasher>("Key", "hash_combine", keys);
+  run<vir::refl::hasher>("WideKey", "vir", wide);
+  run<manual_hasher>("WideKey", "hash_combine", wide);
+  run<vir::refl::hasher>("NamedKey", "vir", named);
+  run<manual_hasher>("NamedKey", "hash_combine", named);
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=200000,
+                        help="number of keys")
+    parser.add_argument("--repeat", type=int, default=20,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="hash.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "hash.cpp")
+        exe = os.path.join(tmp, "hash")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                key, method, t_hash, t_find = line.split()
+                results.append({"compiler": cxx, "key": key, "method": method,
+                                "hash_ns": round(float(t_hash), 3),
+                                "find_ns": round(float(t_find), 3)})
+                print(f"{cxx:>12} {key:>8} {method:>12}: hash {float(t_hash):6.2f} ns, "
+                      f"unordered_map::find {float(t_find):6.2f} ns", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::to_json and from_json.
+
+Formats an array of status records as JSON and compares against a std::ostringstream based emitter
+that builds the keys at run time. Then parses the JSON texts back into the records.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-json.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Position
+{
+  double x, y, z;
+  VIR_MAKE_REFLECTABLE(Position, x, y, z);
+};
+
+struct Status
+{
+  std::uint64_t timestamp;
+  std::uint32_t sensor;
+  bool enabled;
+  std::string state;
+  float temperature, voltage;
+  Position position;
+  std::vector<int> errors;
+  VIR_MAKE_REFLECTABLE(Status, timestamp, sensor, enabled, state, temperature, voltage, position,
+                       errors);
+};
+
+// the stream-based emitter the library replaces
+void
+put_key(std::ostream& os, const std::string& name, bool first)
+{ os << (first ? "{" : ",") << '"' + name + "\":"; }
+
+std::string
+stream_json(const Status& s)
+{
+  std::ostringstream os;
+  os.precision(17);
+  put_key(os, "timestamp", true);
+  os << s.timestamp;
+  put_key(os, "sensor", false);
+  os << s.sensor;
+  put_key(os, "enabled", false);
+  os << (s.enabled ? "true" : "false");
+  put_key(os, "state", false);
+  os << '"' << s.state << '"';
+  put_key(os, "temperature", false);
+  os << s.temperature;
+  put_key(os, "voltage", false);
+  os << s.voltage;
+  put_key(os, "position", false);
+  put_key(os, "x", true);
+  os << s.position.x;
+  put_key(os, "y", false);
+  os << s.position.y;
+  put_key(os, "z", false);
+  os << s.position.z << '}';
+  put_key(os, "errors", false);
+  os << '[';
+  for (std::size_t i = 0; i < s.errors.size(); ++i)
+    os << (i == 0 ? "" : ",") << s.errors[i];
+  os << "]}";
+  return os.str();
+}
+
+template <typename T, typename F>
+  [[gnu::noinline]] void
+  run(const char* method, std::vector<T>& records, F emit)
+  {
+    double t = 1e300;
+    std::size_t bytes = 0;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        bytes = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (T& s : records)
+          bytes += emit(s);
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    std::printf("%s %zu %f\n", method, bytes / records.size(), t / records.size());
+  }
+
+int
+main()
+{
+  std::vector<Status> records(COUNT);
+  for (int i = 0; i < COUNT; ++i)
+    records[i] = {std::uint64_t(1700000000000 + i), std::uint32_t(i % 64), i % 3 != 0, "running",
+                  21.5f + i % 10, 3.3f, {1.25 * i, -0.5, 1e-3}, {i % 7, 42}};
+  run("stream", records, [](const Status& s) { return stream_json(s).size(); });
+  run("vir", records, [buffer = std::string()](const Status& s) mutable {
+    vir::refl::to_json(s, buffer);
+    return buffer.size();
+  });
+
+  std::vector<std::pair<std::string, Status>> parse(records.size());
+  for (std::size_t i = 0; i < records.size(); ++i)
+    vir::refl::to_json(records[i], parse[i].first);
+  run("from_json", parse, [](std::pair<std::string, Status>& p) {
+    if (not vir::refl::from_json(p.first, p.second))
+      std::abort();
+    return p.first.size();
+  });
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=100000,
+                        help="number of records formatted / parsed per pass")
+    parser.add_argument("--repeat", type=int, default=20,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="json_io.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "json_io.cpp")
+        exe = os.path.join(tmp, "json_io")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                method, size, ns = line.split()
+                results.append({"compiler": cxx, "method": method, "bytes": int(size),
+                                "ns": round(float(ns), 2)})
+                print(f"{cxx:>12} {method:>9}: {int(size):3} bytes, {float(ns):7.2f} ns",
+                      flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::schema_loader.
+
+Decodes a buffer of serialized records (16 data members) with the current version of the record
+type (deserialize, and a schema_loader of the unchanged schema) and with an evolved version (two
+data members removed, two added, the rest reordered): via schema_loader, and via a name lookup
+per stored data member and record (visit_data_member(obj, name, ...), i.e. the perfect hash).
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-schema.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+template <int Version>
+  struct Event;
+
+template <>
+  struct Event<1>
+  {
+    std::uint64_t id;
+    std::uint32_t run, lumi;
+    double x, y, z, t;
+    float energy, charge;
+    std::string detector;
+    std::uint32_t flags;
+    double chi2;
+    std::uint16_t hits;
+    std::vector<float> samples;
+    double weight;
+    std::uint64_t mask;
+    VIR_MAKE_REFLECTABLE(Event, id, run, lumi, x, y, z, t, energy, charge, detector, flags, chi2,
+                         hits, samples, weight, mask);
+  };
+
+// flags and mask removed, quality and version added, reordered
+template <>
+  struct Event<2>
+  {
+    std::uint64_t id;
+    std::uint32_t run, lumi;
+    std::string detector;
+    double t, x, y, z;
+    float charge, energy;
+    double chi2;
+    float quality = 1;
+    std::uint16_t hits;
+    std::vector<float> samples;
+    double weight;
+    int version = 2;
+    VIR_MAKE_REFLECTABLE(Event, id, run, lumi, detector, t, x, y, z, charge, energy, chi2, quality,
+                         hits, samples, weight, version);
+  };
+
+template <typename F>
+  double
+  measure(F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    return t / COUNT;
+  }
+
+// decodes all records of buffer with load(obj, bytes) and returns a checksum
+template <typename T>
+  double
+  decode_all(const std::vector<std::byte>& buffer, auto&& load)
+  {
+    T obj {};
+    double sum = 0;
+    std::span<const std::byte> rest = buffer;
+    for (int i = 0; i < COUNT; ++i)
+      {
+        const std::size_t n = load(obj, rest);
+        if (n == 0)
+          return -1;
+        rest = rest.subspan(n);
+        sum += obj.x + obj.hits + obj.samples.size();
+      }
+    return sum;
+  }
+
+int
+main()
+{
+  std::vector<std::byte> buffer;
+  for (int i = 0; i < COUNT; ++i)
+    {
+      const Event<1> e {std::uint64_t(i), 7, std::uint32_t(i / 100), i * 0.5, 1., 2., 3., 4.f,
+                        -1.f, "tracker", 0, 1.5, std::uint16_t(i % 20),
+                        std::vector<float>(i % 4, 1.f), 1., ~0ull};
+      const std::size_t offset = buffer.size();
+      buffer.resize(offset + vir::refl::serialized_size(e));
+      vir::refl::serialize(e, std::span(buffer).subspan(offset));
+    }
+  const vir::refl::record_schema stored = vir::refl::schema_of<Event<1>>();
+  double check = 0;
+
+  const double t_deserialize = measure([&] {
+    check = decode_all<Event<1>>(buffer, [](Event<1>& e, std::span<const std::byte> bytes) {
+              return vir::refl::deserialize(e, bytes);
+            });
+  });
+  const double expected = check;
+
+  const double t_same = measure([&] {
+    const vir::refl::schema_loader<Event<1>> loader(stored);
+    check = decode_all<Event<1>>(buffer, [&](Event<1>& e, std::span<const std::byte> bytes) {
+              return loader.load(e, bytes);
+            });
+  });
+  if (check != expected)
+    std::puts("mismatch");
+
+  const double t_loader = measure([&] {
+    const vir::refl::schema_loader<Event<2>> loader(stored);
+    check = decode_all<Event<2>>(buffer, [&](Event<2>& e, std::span<const std::byte> bytes) {
+              return loader.load(e, bytes);
+            });
+  });
+  if (check != expected)
+    std::puts("mismatch");
+
+  const double t_lookup = measure([&] {
+    check = decode_all<Event<2>>(buffer, [&](Event<2>& e, std::span<const std::byte> bytes) {
+              vir::refl::detail::serial_reader in {bytes.data(), bytes.data() + bytes.size()};
+              for (const vir::refl::member_schema& m : stored.members)
+                {
+                  bool ok = true;
+                  const auto decode = [&](auto& x) {
+                    ok = vir::refl::detail::deserialize_value(in, x);
+                  };
+                  if (not vir::refl::visit_data_member(e, m.name, decode))
+                    {
+                      // removed data member: skip (all of them have a fixed size here)
+                      in.ptr += m.size;
+                    }
+                  if (not ok)
+                    return std::size_t(0);
+                }
+              e.quality = 1;
+              e.version = 2;
+              return std::size_t(in.ptr - bytes.data());
+            });
+  });
+  if (check != expected)
+    std::puts("mismatch");
+
+  std::printf("deserialize %f\nschema_loader(same) %f\nschema_loader(evolved) %f\n"
+              "name_lookup(evolved) %f\n", t_deserialize, t_same, t_loader, t_lookup);
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=1000000,
+                        help="number of records")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="schema.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "schema.cpp")
+        exe = os.path.join(tmp, "schema")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                if line == "mismatch":
+                    sys.exit(f"{cxx}: the decoded records differ")
+                method, ns = line.split()
+                results.append({"compiler": cxx, "method": method,
+                                "ns_per_record": round(float(ns), 2)})
+                print(f"{cxx:>12} {method:>22}: {float(ns):7.2f} ns per record", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
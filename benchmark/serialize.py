@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::serialize / deserialize / view.
+
+Serializes an array of small telemetry records into one buffer and compares against a
+hand-written per-field serializer and against a single memcpy of the record (the lower bound,
+which is only possible if the record is trivially copyable). Both a trivially copyable record and
+one with a std::string member are measured.
+
+For sparse access, 3 of the 40 data members of serialized records (with two std::string members in
+between) are read via full deserialize and via vir::refl::view.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/reflect-light-serialize.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Sample
+{
+  std::uint64_t timestamp;
+  std::uint32_t sensor;
+  std::uint16_t channel, flags;
+  float value, error;
+  double x, y, z;
+  VIR_MAKE_REFLECTABLE(Sample, timestamp, sensor, channel, flags, value, error, x, y, z);
+};
+
+struct Event
+{
+  std::uint64_t timestamp;
+  std::uint32_t sensor;
+  std::uint16_t channel, flags;
+  std::string source;
+  float value, error;
+  double x, y, z;
+  VIR_MAKE_REFLECTABLE(Event, timestamp, sensor, channel, flags, source, value, error, x, y, z);
+};
+
+template <typename T>
+  std::byte*
+  put(std::byte* p, const T& x)
+  {
+    std::memcpy(p, &x, sizeof(T));
+    return p + sizeof(T);
+  }
+
+template <typename T>
+  const std::byte*
+  get(const std::byte* p, T& x)
+  {
+    std::memcpy(&x, p, sizeof(T));
+    return p + sizeof(T);
+  }
+
+std::byte*
+put(std::byte* p, const std::string& s)
+{
+  p = put(p, std::uint64_t(s.size()));
+  std::memcpy(p, s.data(), s.size());
+  return p + s.size();
+}
+
+const std::byte*
+get(const std::byte* p, std::string& s)
+{
+  std::uint64_t n;
+  p = get(p, n);
+  s.assign(reinterpret_cast<const char*>(p), n);
+  return p + n;
+}
+
+// the per-field serializer the library replaces
+template <typename T>
+  std::size_t
+  by_field_serialize(const T& r, std::span<std::byte> buf)
+  {
+    std::byte* p = buf.data();
+    p = put(p, r.timestamp);
+    p = put(p, r.sensor);
+    p = put(p, r.channel);
+    p = put(p, r.flags);
+    if constexpr (requires { r.source; })
+      p = put(p, r.source);
+    p = put(p, r.value);
+    p = put(p, r.error);
+    p = put(p, r.x);
+    p = put(p, r.y);
+    p = put(p, r.z);
+    return p - buf.data();
+  }
+
+template <typename T>
+  std::size_t
+  by_field_deserialize(T& r, std::span<const std::byte> buf)
+  {
+    const std::byte* p = buf.data();
+    p = get(p, r.timestamp);
+    p = get(p, r.sensor);
+    p = get(p, r.channel);
+    p = get(p, r.flags);
+    if constexpr (requires { r.source; })
+      p = get(p, r.source);
+    p = get(p, r.value);
+    p = get(p, r.error);
+    p = get(p, r.x);
+    p = get(p, r.y);
+    p = get(p, r.z);
+    return p - buf.data();
+  }
+
+template <typename T>
+  std::size_t
+  memcpy_serialize(const T& r, std::span<std::byte> buf)
+  {
+    std::memcpy(buf.data(), &r, sizeof(T));
+    return sizeof(T);
+  }
+
+template <typename T>
+  std::size_t
+  memcpy_deserialize(T& r, std::span<const std::byte> buf)
+  {
+    std::memcpy(&r, buf.data(), sizeof(T));
+    return sizeof(T);
+  }
+
+template <typename T, typename Ser, typename De>
+  [[gnu::noinline]] void
+  run(const char* type, const char* method, std::vector<T>& records, Ser ser, De de)
+  {
+    std::vector<std::byte> buffer(records.size() * (sizeof(T) + 64));
+    std::vector<T> out(records.size());
+    std::size_t bytes = 0;
+    double t_ser = 1e300, t_de = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        std::span<std::byte> rest = buffer;
+        for (const T& x : records)
+          rest = rest.subspan(ser(x, rest));
+        auto t1 = std::chrono::steady_clock::now();
+        bytes = buffer.size() - rest.size();
+        std::span<const std::byte> in = std::span(buffer).first(bytes);
+        for (T& x : out)
+          in = in.subspan(de(x, in));
+        auto t2 = std::chrono::steady_clock::now();
+        t_ser = std::min(t_ser, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        t_de = std::min(t_de, std::chrono::duration<double, std::nano>(t2 - t1).count());
+      }
+    if (std::memcmp(&out.back().timestamp, &records.back().timestamp, 8) != 0)
+      std::puts("mismatch");
+    std::printf("%s %s %zu %f %f\n", type, method, bytes / records.size(),
+                t_ser / records.size(), t_de / records.size());
+  }
+
+WIDE_STRUCT
+
+template <typename Read>
+  [[gnu::noinline]] void
+  run_sparse(const char* method, std::span<const std::byte> buffer, std::size_t count, Read read)
+  {
+    double t = 1e300;
+    double sum = 0;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        std::span<const std::byte> in = buffer;
+        for (std::size_t i = 0; i < count; ++i)
+          in = in.subspan(read(in, sum));
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    if (sum == 0.5)
+      std::puts("");
+    std::printf("sparse %s %zu %f\n", method, buffer.size() / count, t / count);
+  }
+
+int
+main()
+{
+  std::vector<Sample> samples(COUNT);
+  std::vector<Event> events(COUNT);
+  for (int i = 0; i < COUNT; ++i)
+    {
+      samples[i] = {std::uint64_t(i), 7u, 1, 2, 1.f * i, 0.5f, 1., 2., 3.};
+      events[i] = {std::uint64_t(i), 7u, 1, 2, "detector", 1.f * i, 0.5f, 1., 2., 3.};
+    }
+  auto ser = [](const auto& x, auto buf) { return vir::refl::serialize(x, buf); };
+  auto de = [](auto& x, auto buf) { return vir::refl::deserialize(x, buf); };
+  auto field_ser = [](const auto& x, auto buf) { return by_field_serialize(x, buf); };
+  auto field_de = [](auto& x, auto buf) { return by_field_deserialize(x, buf); };
+  auto memcpy_ser = [](const auto& x, auto buf) { return memcpy_serialize(x, buf); };
+  auto memcpy_de = [](auto& x, auto buf) { return memcpy_deserialize(x, buf); };
+  run("trivial", "memcpy", samples, memcpy_ser, memcpy_de);
+  run("trivial", "vir", samples, ser, de);
+  run("trivial", "per-field", samples, field_ser, field_de);
+  run("string", "vir", events, ser, de);
+  run("string", "per-field", events, field_ser, field_de);
+
+  std::vector<Wide> wide(COUNT / 10);
+  for (Wide& w : wide)
+    w.s10 = w.s30 = "some name";
+  std::vector<std::byte> buffer(wide.size() * vir::refl::serialized_size(wide[0]));
+  std::span<std::byte> rest = buffer;
+  for (const Wide& w : wide)
+    rest = rest.subspan(vir::refl::serialize(w, rest));
+  run_sparse("deserialize", buffer, wide.size(), [](auto in, double& sum) {
+    Wide w;
+    const std::size_t n = vir::refl::deserialize(w, in);
+    sum += w.f5 + w.f20 + w.f35;
+    return n;
+  });
+  run_sparse("view", buffer, wide.size(), [](auto in, double& sum) {
+    const vir::refl::view<Wide> v(in);
+    sum += vir::refl::data_member<"f5">(v) + vir::refl::data_member<"f20">(v)
+             + vir::refl::data_member<"f35">(v);
+    return v.bytes().size();
+  });
+}
+"""
+
+
+def wide_struct(n=40):
+    types = ["double", "float", "int", "std::uint16_t"]
+    members = [("std::string", f"s{i}") if i in (10, 30) else (types[i % len(types)], f"f{i}")
+               for i in range(n)]
+    return ("struct Wide\n{\n"
+            + "".join(f"  {t} {name} = {{}};\n" for t, name in members)
+            + f"  VIR_MAKE_REFLECTABLE(Wide, {', '.join(name for _, name in members)});\n}};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=100000,
+                        help="number of records serialized per pass")
+    parser.add_argument("--repeat", type=int, default=50,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="serialize.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "serialize.cpp")
+        exe = os.path.join(tmp, "serialize")
+        with open(src, "w") as f:
+            f.write(SOURCE.replace("WIDE_STRUCT", wide_struct()))
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                if line.startswith("sparse "):
+                    _, method, size, ns = line.split()
+                    results.append({"compiler": cxx, "record": "sparse", "method": method,
+                                    "bytes": int(size), "ns": round(float(ns), 2)})
+                    print(f"{cxx:>12} 3 of 40 members via {method:>11}: {float(ns):6.2f} ns",
+                          flush=True)
+                    continue
+                record, method, size, ser, de = line.split()
+                results.append({"compiler": cxx, "record": record, "method": method,
+                                "bytes": int(size), "serialize_ns": round(float(ser), 2),
+                                "deserialize_ns": round(float(de), 2)})
+                print(f"{cxx:>12} {record:>8} {method:>10}: {int(size):3} bytes, "
+                      f"serialize {float(ser):6.2f} ns, deserialize {float(de):6.2f} ns",
+                      flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
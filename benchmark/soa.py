@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::soa_vector and vir::refl::aosoa_vector.
+
+Fills a std::vector (array of structures), a soa_vector (structure of arrays), and an aosoa_vector
+(array of SIMD-width tiles) with the same records and compares loops that scan one or two data
+members of all records, as well as refilling the containers with push_back (after clear(), i.e.
+without allocations). A kernel that reads all 12 data members of a second record type shows the
+cost of accessing 12 separate columns.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/aosoa_vector.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// 64 bytes per record
+struct Hit
+{
+  std::uint64_t event;
+  std::uint32_t detector, channel;
+  double x, y, z;
+  float energy, time;
+  double weight;
+  std::uint64_t flags;
+  VIR_MAKE_REFLECTABLE(Hit, event, detector, channel, x, y, z, energy, time, weight, flags);
+};
+
+// 12 data members, all read by the track kernel (which stores one result per record)
+struct Track
+{
+  float x, y, z, px, py, pz, energy, time, charge, chi2, weight, length;
+  VIR_MAKE_REFLECTABLE(Track, x, y, z, px, py, pz, energy, time, charge, chi2, weight, length);
+};
+
+inline float
+kernel(float x, float y, float z, float px, float py, float pz, float energy, float time,
+       float charge, float chi2, float weight, float length)
+{
+  return (energy * energy - px * px - py * py - pz * pz) * weight * charge
+           + (x * px + y * py + z * pz) * time - chi2 * length;
+}
+
+// writes the kernel result for every record to out
+template <typename V>
+  void
+  track_kernel(const V& v, float* out)
+  {
+    if constexpr (requires { v.tile_count(); })
+      for (std::size_t t = 0; t < v.tile_count(); ++t)
+        {
+          const auto x = v.template column<"x">(t);
+          const auto y = v.template column<"y">(t);
+          const auto z = v.template column<"z">(t);
+          const auto px = v.template column<"px">(t);
+          const auto py = v.template column<"py">(t);
+          const auto pz = v.template column<"pz">(t);
+          const auto e = v.template column<"energy">(t);
+          const auto time = v.template column<"time">(t);
+          const auto q = v.template column<"charge">(t);
+          const auto chi2 = v.template column<"chi2">(t);
+          const auto w = v.template column<"weight">(t);
+          const auto l = v.template column<"length">(t);
+          for (std::size_t i = 0; i < x.size(); ++i)
+            out[i] = kernel(x[i], y[i], z[i], px[i], py[i], pz[i], e[i], time[i], q[i], chi2[i],
+                            w[i], l[i]);
+          out += x.size();
+        }
+    else
+      {
+        const auto x = v.template column<"x">();
+        const auto y = v.template column<"y">();
+        const auto z = v.template column<"z">();
+        const auto px = v.template column<"px">();
+        const auto py = v.template column<"py">();
+        const auto pz = v.template column<"pz">();
+        const auto e = v.template column<"energy">();
+        const auto time = v.template column<"time">();
+        const auto q = v.template column<"charge">();
+        const auto chi2 = v.template column<"chi2">();
+        const auto w = v.template column<"weight">();
+        const auto l = v.template column<"length">();
+        for (std::size_t i = 0; i < x.size(); ++i)
+          out[i] = kernel(x[i], y[i], z[i], px[i], py[i], pz[i], e[i], time[i], q[i], chi2[i],
+                          w[i], l[i]);
+      }
+  }
+
+template <typename F>
+  [[gnu::noinline]] void
+  run(const char* layout, const char* loop, F f)
+  {
+    double t = 1e300;
+    double result = 0;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        result += f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    if (result == 0.5)
+      std::puts("");
+    std::printf("%s %s %f\n", layout, loop, t / COUNT);
+  }
+
+Hit
+make_hit(int i)
+{ return {std::uint64_t(i), std::uint32_t(i % 16), std::uint32_t(i % 64), 0.1 * i, 0.2, 0.3,
+          float(i % 100), 1.f, 1., 0}; }
+
+int
+main()
+{
+  std::vector<Hit> aos;
+  vir::refl::soa_vector<Hit> soa;
+  run("aos", "push_back", [&] {
+    aos.clear();
+    for (int i = 0; i < COUNT; ++i)
+      aos.push_back(make_hit(i));
+    return aos.size();
+  });
+  run("soa", "push_back", [&] {
+    soa.clear();
+    for (int i = 0; i < COUNT; ++i)
+      soa.push_back(make_hit(i));
+    return soa.size();
+  });
+  vir::refl::aosoa_vector<Hit> aosoa;
+  run("aosoa", "push_back", [&] {
+    aosoa.clear();
+    for (int i = 0; i < COUNT; ++i)
+      aosoa.push_back(make_hit(i));
+    return aosoa.size();
+  });
+  run("aos", "sum(energy)", [&] {
+    float sum = 0;
+    for (const Hit& h : aos)
+      sum += h.energy;
+    return sum;
+  });
+  run("soa", "sum(energy)", [&] {
+    float sum = 0;
+    for (float e : soa.column<"energy">())
+      sum += e;
+    return sum;
+  });
+  run("aosoa", "sum(energy)", [&] {
+    float sum = 0;
+    for (std::size_t t = 0; t < aosoa.tile_count(); ++t)
+      for (float e : aosoa.column<"energy">(t))
+        sum += e;
+    return sum;
+  });
+  run("aos", "sum(x*weight)", [&] {
+    double sum = 0;
+    for (const Hit& h : aos)
+      sum += h.x * h.weight;
+    return sum;
+  });
+  run("soa", "sum(x*weight)", [&] {
+    double sum = 0;
+    const auto x = soa.column<"x">();
+    const auto w = soa.column<"weight">();
+    for (std::size_t i = 0; i < x.size(); ++i)
+      sum += x[i] * w[i];
+    return sum;
+  });
+  run("aosoa", "sum(x*weight)", [&] {
+    double sum = 0;
+    for (std::size_t t = 0; t < aosoa.tile_count(); ++t)
+      {
+        const auto x = aosoa.column<"x">(t);
+        const auto w = aosoa.column<"weight">(t);
+        for (std::size_t i = 0; i < x.size(); ++i)
+          sum += x[i] * w[i];
+      }
+    return sum;
+  });
+  aos = {};
+  soa = {};
+  aosoa = {};
+
+  std::vector<Track> tracks_aos;
+  vir::refl::soa_vector<Track> tracks_soa;
+  vir::refl::aosoa_vector<Track> tracks_aosoa;
+  for (int i = 0; i < COUNT; ++i)
+    {
+      const float f = i % 1000 * 0.001f;
+      const Track t = {f, f, f, f, f, f, 2 * f, 1, 1, f, 1, f};
+      tracks_aos.push_back(t);
+      tracks_soa.push_back(t);
+      tracks_aosoa.push_back(t);
+    }
+  std::vector<float> out(COUNT);
+  run("aos", "track(12)", [&] {
+    for (std::size_t i = 0; i < tracks_aos.size(); ++i)
+      {
+        const Track& t = tracks_aos[i];
+        out[i] = kernel(t.x, t.y, t.z, t.px, t.py, t.pz, t.energy, t.time, t.charge, t.chi2,
+                        t.weight, t.length);
+      }
+    return out.back();
+  });
+  run("soa", "track(12)", [&] {
+    track_kernel(tracks_soa, out.data());
+    return out.back();
+  });
+  run("aosoa", "track(12)", [&] {
+    track_kernel(tracks_aosoa, out.data());
+    return out.back();
+  });
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=4000000,
+                        help="number of records")
+    parser.add_argument("--repeat", type=int, default=20,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="soa.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "soa.cpp")
+        exe = os.path.join(tmp, "soa")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                layout, loop, ns = line.split()
+                results.append({"compiler": cxx, "layout": layout, "loop": loop,
+                                "ns_per_record": round(float(ns), 3)})
+                print(f"{cxx:>12} {layout:>5} {loop:>14}: {float(ns):7.3f} ns per record",
+                      flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::tracked.
+
+A settings struct with 48 data members (double, float, and int) receives one write per update;
+the apply step then processes the data members that changed. The changed data members are found
+by comparing against a copy of the last applied settings (diff), or from the dirty bits of
+tracked<Settings> (for_each_dirty / clear_dirty).
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/tracked.h>
+#include <chrono>
+#include <cstdio>
+
+struct Settings
+{
+  @MEMBERS@
+};
+
+template <typename F>
+  double
+  measure(F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    return t / COUNT;
+  }
+
+// writes one data member (the same sequence for every method) via data_member<Idx>() of
+// tracked<Settings> or plain
+template <typename S>
+  void
+  update(S& settings, int i)
+  {
+    switch (i % 4)
+      {
+      case 0:
+        settings.template data_member<3>() += 1;
+        break;
+      case 1:
+        settings.template data_member<17>() += 1;
+        break;
+      case 2:
+        settings.template data_member<30>() += 1;
+        break;
+      default:
+        settings.template data_member<46>() += 1;
+        break;
+      }
+  }
+
+struct plain
+{
+  Settings value {};
+
+  template <std::size_t Idx>
+    auto&
+    data_member()
+    { return vir::refl::data_member<Idx>(value); }
+};
+
+int
+main()
+{
+  double check = 0;
+
+  const double t_diff = measure([&] {
+    plain settings;
+    Settings applied {};
+    double sum = 0;
+    for (int i = 0; i < COUNT; ++i)
+      {
+        update(settings, i);
+        const auto changed = vir::refl::diff(applied, settings.value);
+        applied = settings.value;
+        vir::refl::for_each_data_member_index<Settings>([&](auto idx) {
+          if (changed[idx])
+            sum += vir::refl::data_member<idx>(applied);
+        });
+      }
+    check = sum;
+  });
+  const double expected = check;
+
+  const double t_tracked = measure([&] {
+    vir::refl::tracked<Settings> settings;
+    double sum = 0;
+    for (int i = 0; i < COUNT; ++i)
+      {
+        update(settings, i);
+        settings.for_each_dirty([&](auto, auto value) { sum += value; });
+        settings.clear_dirty();
+      }
+    check = sum;
+  });
+  if (check != expected)
+    std::puts("mismatch");
+
+  std::printf("diff %f\ntracked %f\n", t_diff, t_tracked);
+}
+"""
+
+
+def settings_members():
+    """The 48 data members of Settings: 24 double, 16 float, and 8 int, interleaved."""
+    types = ["double", "float", "double", "int", "double", "float"] * 8
+    names = [f"m{i}" for i in range(len(types))]
+    decls = "".join(f"{t} {n};\n  " for t, n in zip(types, names))
+    return decls + f"VIR_MAKE_REFLECTABLE(Settings, {', '.join(names)});"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=1000000,
+                        help="number of updates")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="tracked.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "tracked.cpp")
+        exe = os.path.join(tmp, "tracked")
+        with open(src, "w") as f:
+            f.write(SOURCE.replace("@MEMBERS@", settings_members()))
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                if line == "mismatch":
+                    sys.exit(f"{cxx}: the applied data members differ")
+                method, ns = line.split()
+                results.append({"compiler": cxx, "method": method,
+                                "ns_per_update": round(float(ns), 2)})
+                print(f"{cxx:>12} {method:>8}: {float(ns):7.2f} ns per update", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
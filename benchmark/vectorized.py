@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::vectorized.
+
+Runs one DSP kernel (rotate the I/Q samples by a constant phase and scale them) over an array of
+samples: per sample on a std::vector<Sample>, and on vectorized<Sample> loaded from the
+std::vector (array of structures), from a soa_vector, and from the tiles of an aosoa_vector.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = r"""
+#include <vir/vectorized.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+struct Sample
+{
+  float i, q;
+  int flags;
+  VIR_MAKE_REFLECTABLE(Sample, i, q, flags);
+};
+
+// the same code for one Sample and for vectorized<Sample>
+template <typename S>
+  inline void
+  rotate(S& s)
+  {
+    using vir::refl::data_member;
+    constexpr float c = 0.8f * 0.6f, sn = 0.8f * 0.8f;
+    const auto i = data_member<"i">(s);
+    const auto q = data_member<"q">(s);
+    data_member<"i">(s) = i * c - q * sn;
+    data_member<"q">(s) = i * sn + q * c;
+  }
+
+template <typename F>
+  [[gnu::noinline]] void
+  run(const char* method, F f)
+  {
+    double t = 1e300;
+    for (int r = 0; r < REPEAT; ++r)
+      {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        t = std::min(t, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+    std::printf("%s %f\n", method, t / COUNT);
+  }
+
+int
+main()
+{
+  using V = vir::refl::vectorized<Sample>;
+  static_assert(COUNT % V::size == 0);
+  std::vector<Sample> aos(COUNT);
+  vir::refl::soa_vector<Sample> soa;
+  vir::refl::aosoa_vector<Sample> aosoa;
+  for (int k = 0; k < COUNT; ++k)
+    {
+      aos[k] = {0.001f * k, 1.f, k};
+      soa.push_back(aos[k]);
+      aosoa.push_back(aos[k]);
+    }
+  run("scalar(aos)", [&] {
+    for (Sample& s : aos)
+      rotate(s);
+  });
+  run("vectorized(aos)", [&] {
+    for (std::size_t k = 0; k < aos.size(); k += V::size)
+      {
+        V v(aos.data() + k);
+        rotate(v);
+        v.copy_to(aos.data() + k);
+      }
+  });
+  run("vectorized(soa)", [&] {
+    for (std::size_t k = 0; k < soa.size(); k += V::size)
+      {
+        V v;
+        v.copy_from(soa, k);
+        rotate(v);
+        v.copy_to(soa, k);
+      }
+  });
+  run("vectorized(aosoa)", [&] {
+    for (std::size_t t = 0; t < aosoa.tile_count(); ++t)
+      {
+        V v;
+        v.copy_from(aosoa, t);
+        rotate(v);
+        v.copy_to(aosoa, t);
+      }
+  });
+  if (Sample(soa[COUNT - 1]).q != Sample(aosoa[COUNT - 1]).q)
+    std::puts("mismatch");
+}
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--records", type=int, default=65536,
+                        help="number of samples (a multiple of the SIMD width)")
+    parser.add_argument("--repeat", type=int, default=200,
+                        help="number of passes (the fastest is reported)")
+    parser.add_argument("-o", "--output", default="vectorized.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "vectorized.cpp")
+        exe = os.path.join(tmp, "vectorized")
+        with open(src, "w") as f:
+            f.write(SOURCE)
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split()
+                           + [f"-DCOUNT={args.records}", f"-DREPEAT={args.repeat}",
+                              "-I", SRCDIR, src, "-o", exe], check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                method, ns = line.split()
+                results.append({"compiler": cxx, "method": method,
+                                "ns_per_sample": round(float(ns), 3)})
+                print(f"{cxx:>12} {method:>17}: {float(ns):6.3f} ns per sample", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+"""Run-time benchmark of vir::refl::visit_data_member (perfect hash) against a linear scan.
+
+Generates reflectable structs with the requested member counts, compiles one benchmark executable
+per compiler, and measures the time per lookup of known names (in random order) and of unknown
+names (same lengths as the known ones).
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SRCDIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WORDS = ["sample", "rate", "gain", "delay", "buffer", "channel", "filter", "cutoff", "mode",
+         "level", "phase", "offset", "threshold", "window", "decimation", "trigger"]
+
+MEMBER_TYPES = ["int", "float", "double", "unsigned", "short", "bool"]
+
+
+def member_names(n):
+    rng = random.Random(n)
+    return [f"{rng.choice(WORDS)}_{rng.choice(WORDS)}_{i}" for i in range(n)]
+
+
+def unknown_name(name):
+    # same length and prefix, differs in the last character
+    return name[:-1] + ("x" if name[-1] != "x" else "y")
+
+
+def generate(counts, repeat):
+    out = ["#include <vir/reflect-light.h>",
+           "#include <chrono>",
+           "#include <cstdio>",
+           "#include <string>",
+           "#include <vector>",
+           "",
+           "template <typename T>",
+           "  bool",
+           "  linear_visit(T& obj, std::string_view name, auto&& fun)",
+           "  {",
+           "    bool found = false;",
+           "    vir::refl::for_each_data_member_index<T>([&](auto idx) {",
+           "      if (not found and vir::refl::data_member_name<T, idx> == name)",
+           "        {",
+           "          fun(vir::refl::data_member<idx>(obj));",
+           "          found = true;",
+           "        }",
+           "    });",
+           "    return found;",
+           "  }",
+           "",
+           "template <typename T>",
+           "  bool",
+           "  hash_visit(T& obj, std::string_view name, auto&& fun)",
+           "  { return vir::refl::visit_data_member(obj, name, fun); }",
+           "",
+           "template <typename T, typename Visit>",
+           "  [[gnu::noinline]] double",
+           "  ns_per_lookup(T& obj, const std::vector<std::string>& queries, Visit visit)",
+           "  {",
+           "    long hits = 0;",
+           "    const auto start = std::chrono::steady_clock::now();",
+           f"    for (int r = 0; r < {repeat}; ++r)",
+           "      for (const std::string& q : queries)",
+           "        hits += visit(obj, q, [](auto& x) { x += 1; });",
+           "    const std::chrono::duration<double, std::nano> t",
+           "      = std::chrono::steady_clock::now() - start;",
+           "    if (hits < 0)",
+           "      std::puts(\"\");",
+           f"    return t.count() / ({repeat} * double(queries.size()));",
+           "  }",
+           ""]
+    for n in counts:
+        names = member_names(n)
+        out.append(f"struct S{n}\n{{")
+        out += [f"  {MEMBER_TYPES[i % len(MEMBER_TYPES)]} {name};" for i, name in enumerate(names)]
+        out.append(f"  VIR_MAKE_REFLECTABLE(S{n}, {', '.join(names)});\n}};\n")
+    out.append("int\nmain()\n{")
+    for n in counts:
+        names = member_names(n)
+        known = names[:]
+        random.Random(0).shuffle(known)
+        unknown = [unknown_name(x) for x in known]
+        out.append("  {")
+        out.append(f"    static S{n} obj = {{}};")
+        out.append("    const std::vector<std::string> known = {"
+                   + ", ".join(f'"{x}"' for x in known) + "};")
+        out.append("    const std::vector<std::string> unknown = {"
+                   + ", ".join(f'"{x}"' for x in unknown) + "};")
+        for kind in ("known", "unknown"):
+            for visit in ("hash", "linear"):
+                out.append(f'    std::printf("{n} {kind} {visit} %f\\n", '
+                           f"ns_per_lookup(obj, {kind}, [](auto&&... a) "
+                           f"{{ return {visit}_visit(a...); }}));")
+        out.append("  }")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--cxx", nargs="+", default=None,
+                        help="compilers to benchmark (default: $CXX or g++ and clang++)")
+    parser.add_argument("--cxxflags", default="-std=c++20 -O2",
+                        help="flags passed to every compilation")
+    parser.add_argument("--members", nargs="+", type=int, default=[8, 64, 256])
+    parser.add_argument("--repeat", type=int, default=20000,
+                        help="number of passes over all names")
+    parser.add_argument("-o", "--output", default="visit.json")
+    args = parser.parse_args()
+
+    compilers = args.cxx
+    if compilers is None:
+        compilers = [os.environ["CXX"]] if "CXX" in os.environ else ["g++", "clang++"]
+    compilers = [c for c in compilers if shutil.which(c)]
+    if not compilers:
+        sys.exit("no compiler found")
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "visit.cpp")
+        exe = os.path.join(tmp, "visit")
+        with open(src, "w") as f:
+            f.write(generate(args.members, args.repeat))
+        for cxx in compilers:
+            subprocess.run([cxx] + args.cxxflags.split() + ["-I", SRCDIR, src, "-o", exe],
+                           check=True)
+            run = subprocess.run([exe], check=True, capture_output=True, text=True)
+            for line in run.stdout.splitlines():
+                members, names, visit, ns = line.split()
+                results.append({"compiler": cxx, "members": int(members), "names": names,
+                                "visit": visit, "ns_per_lookup": round(float(ns), 2)})
+                print(f"{cxx:>12} {members:>4} members, {names:>7} names, {visit:>6}: "
+                      f"{float(ns):8.2f} ns", flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"cxxflags": args.cxxflags, "results": results}, f, indent=1)
+        f.write("\n")
+    print(f"results written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
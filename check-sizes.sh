@@ -0,0 +1,124 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-3.0-or-later
+# Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+#                       Matthias Kretz <m.kretz@gsi.de>
+
+# Usage: ./check-sizes.sh [--update] [<compiler> ...]
+#
+# Compiles every size-check/*.cpp with each compiler at -O0 and -O2 and compares the number of
+# defined symbols, the number of fixed_string template parameter objects, and the size of constant
+# data against the budgets stated in the TU:
+#
+#   // budget <gcc|clang> <-O0|-O2>: <n> symbols, <n> fixed_strings, <n> bytes .rodata
+#
+# Budgets are upper bounds. A TU without budget for a compiler/flags combination is only reported.
+#
+# --update records the measured values plus a margin as the budgets of the given compilers:
+# 5% (at least 2) more symbols, 5% (at least 16) more bytes of .rodata, and one more fixed_string
+# unless there is none (a TU without fixed_strings is meant to stay that way). Thus, unrelated
+# small changes pass, while regressions of a facility still fail.
+#
+# The clang budgets are provisional: they were derived from the gcc measurements with a margin of
+# 25% (at least 8 symbols / 32 bytes). Record them with --update on a system with clang.
+
+cd "$(dirname "$0")"
+update=false
+if test "$1" = --update; then
+  update=true
+  shift
+fi
+test $# -eq 0 && set -- "${CXX:-c++}"
+
+# with_margin <measured> <minimum> <percent>
+with_margin() {
+  add=$(($1 * $3 / 100))
+  test $add -lt $2 && add=$2
+  echo $(($1 + add))
+}
+
+# record_budget <src> <family> <opt> <symbols> <fixed_strings> <rodata>
+record_budget() {
+  strings=$5
+  test "$strings" -gt 0 && strings=$((strings + 1))
+  line="// budget $2 $3: $(with_margin $4 2 5) symbols, $strings fixed_strings, \
+$(with_margin $6 16 5) bytes .rodata"
+  if grep -q "^// budget $2 $3:" "$1"; then
+    sed -i "s|^// budget $2 $3:.*|$line|" "$1"
+  else
+    # after the last budget line
+    last=$(grep -n '^// budget ' "$1"|tail -n1|cut -d: -f1)
+    sed -i "${last}a\\
+$line" "$1"
+  fi
+}
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+failed=false
+
+# compare <measured> <budget>
+compare() {
+  if test -z "$2"; then
+    printf "%5s      " "$1"
+  elif test "$1" -le "$2"; then
+    printf "%5s/%-3s✔️ " "$1" "$2"
+  else
+    printf "%5s/%-3s❌ " "$1" "$2"
+    failed=true
+  fi
+}
+
+printf "%-32s | %-13s| %-13s| %s\n" "TU" "symbols" "fixed_strings" ".rodata"
+for cxx in "$@"; do
+  if ! command -v "$cxx" >/dev/null; then
+    echo "$cxx: not found, skipped"
+    continue
+  fi
+  family=gcc
+  $cxx --version | grep -qi clang && family=clang
+  for opt in -O0 -O2; do
+    for src in size-check/*.cpp; do
+      obj="$tmp/$(basename "$src" .cpp).o"
+      if ! $cxx -std=c++20 $opt -g0 -I. -c "$src" -o "$obj"; then
+        echo "$src: compilation with $cxx $opt failed"
+        failed=true
+        continue
+      fi
+      symbols="$(nm -SC "$obj"|grep -v ' [Uw] ')"
+      symbol_count=$(echo "$symbols"|grep -c .)
+      string_count=$(echo "$symbols"|grep -c ' [Vu] template parameter object for vir::fixed_string<')
+      rodata_size=0
+      for n in $(echo "$symbols"|grep -E '^[0-9a-f]+ [0-9a-f]+ [VurR] '|cut -d' ' -f2); do
+        rodata_size=$((rodata_size + 0x$n))
+      done
+
+      budget=$(sed -n "s/^\/\/ budget $family $opt: *//p" "$src")
+      budget_symbols=$(echo "$budget"|sed -n 's/.*\<\([0-9]*\) symbols.*/\1/p')
+      budget_strings=$(echo "$budget"|sed -n 's/.*\<\([0-9]*\) fixed_strings.*/\1/p')
+      budget_rodata=$(echo "$budget"|sed -n 's/.*\<\([0-9]*\) bytes .rodata.*/\1/p')
+
+      printf "%-32s | " "$(basename "$src" .cpp) $family $opt"
+      compare $symbol_count "$budget_symbols"
+      printf "| "
+      compare $string_count "$budget_strings"
+      printf "| "
+      compare $rodata_size "$budget_rodata"
+      test -z "$budget" && printf "(no budget)"
+      echo
+      $update && record_budget "$src" $family $opt $symbol_count $string_count $rodata_size
+    done
+  done
+done
+
+if $update; then
+  echo "=> budgets updated."
+  exit 0
+fi
+
+if $failed; then
+  echo "=> FAILED."
+  exit 1
+fi
+
+echo "=> PASSED."
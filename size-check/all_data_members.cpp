@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 69 symbols, 0 fixed_strings, 40 bytes .rodata
+// budget gcc -O2: 4 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 82 symbols, 0 fixed_strings, 56 bytes .rodata
+// budget clang -O2: 10 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Base
+{
+  int id;
+  VIR_MAKE_REFLECTABLE(Base, id);
+};
+
+struct Point : Base
+{
+  float x, y;
+  VIR_MAKE_REFLECTABLE(Point, x, y);
+};
+
+float
+all_data_members_sum(const Point& p)
+{
+  float sum = 0;
+  vir::refl::all_data_members(p).for_each([&](const auto& m) { sum += m; });
+  return sum;
+}
+
+void
+all_data_members_zero(Point& p)
+{ vir::refl::all_data_members(p).for_each([](auto& m) { m = 0; }); }
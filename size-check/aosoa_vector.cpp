@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 218 symbols, 0 fixed_strings, 163 bytes .rodata
+// budget gcc -O2: 5 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 260 symbols, 0 fixed_strings, 183 bytes .rodata
+// budget clang -O2: 11 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/aosoa_vector.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// a loop over one data member, tile by tile
+float
+sum_x(const vir::refl::aosoa_vector<Record>& v)
+{
+  float sum = 0;
+  for (size_t t = 0; t < v.tile_count(); ++t)
+    for (float x : v.column<"x">(t))
+      sum += x;
+  return sum;
+}
+
+void
+add(vir::refl::aosoa_vector<Record>& v, const Record& r)
+{ v.push_back(r); }
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 13 symbols, 2 fixed_strings, 48 bytes .rodata
+// budget gcc -O2: 5 symbols, 2 fixed_strings, 24 bytes .rodata
+// budget clang -O0: 19 symbols, 2 fixed_strings, 64 bytes .rodata
+// budget clang -O2: 11 symbols, 2 fixed_strings, 40 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+namespace ns
+{
+  template <typename T>
+    struct Type
+    {
+      int blah;
+      VIR_MAKE_REFLECTABLE(ns::Type<T>, blah);
+    };
+}
+
+// both need the same string => one template parameter object
+const char*
+class_name_int()
+{ return vir::refl::class_name<ns::Type<int>>.data(); }
+
+std::string_view
+class_name_float()
+{ return vir::refl::class_name<ns::Type<float>>; }
@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 682 symbols, 2 fixed_strings, 509 bytes .rodata
+// budget gcc -O2: 30 symbols, 2 fixed_strings, 91 bytes .rodata
+// budget clang -O0: 812 symbols, 2 fixed_strings, 606 bytes .rodata
+// budget clang -O2: 36 symbols, 2 fixed_strings, 107 bytes .rodata
+
+#include <vir/columnar_file.h>
+
+#ifdef VIR_HAVE_COLUMNAR_FILE
+
+struct Sample
+{
+  std::uint64_t timestamp;
+  std::uint32_t channel;
+  float gain;
+  double value;
+  VIR_MAKE_REFLECTABLE(Sample, timestamp, channel, gain, value);
+};
+
+bool
+store(const std::vector<Sample>& samples)
+{ return vir::refl::write_columns("samples.col", samples); }
+
+// reads one column
+double
+sum_values(const char* path)
+{
+  const vir::refl::columnar_file<Sample> file(path);
+  double sum = 0;
+  for (double x : file.column<"value">())
+    sum += x;
+  return sum;
+}
+#endif
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 106 symbols, 0 fixed_strings, 298 bytes .rodata
+// budget gcc -O2: 5 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 126 symbols, 0 fixed_strings, 352 bytes .rodata
+// budget clang -O2: 11 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light-compare.h>
+
+struct Record
+{
+  std::uint32_t run, lumi;
+  std::uint64_t event;
+  float energy;
+  std::string name;
+  VIR_MAKE_REFLECTABLE(Record, run, lumi, event, energy, name);
+};
+
+constexpr std::array<size_t, 3> key = {0, 1, 2};
+
+// one 16-byte block
+bool
+same_key(const Record& a, const Record& b)
+{ return vir::refl::equal_by<key>(a, b); }
+
+bool
+less_key(const Record& a, const Record& b)
+{ return vir::refl::compare_by<key>(a, b) < 0; }
+
+bool
+less(const Record& a, const Record& b)
+{ return vir::refl::compare(a, b) < 0; }
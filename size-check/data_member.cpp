@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 40 symbols, 0 fixed_strings, 61 bytes .rodata
+// budget gcc -O2: 4 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 47 symbols, 0 fixed_strings, 77 bytes .rodata
+// budget clang -O2: 10 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Base
+{
+  int id;
+  VIR_MAKE_REFLECTABLE(Base, id);
+};
+
+struct Point : Base
+{
+  float x, y;
+  VIR_MAKE_REFLECTABLE(Point, x, y);
+};
+
+int&
+data_member_id(Point& p)
+{ return vir::refl::data_member<"id">(p); }
+
+float
+data_member_y(const Point& p)
+{ return vir::refl::data_member<2>(p); }
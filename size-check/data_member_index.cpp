@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 18 symbols, 0 fixed_strings, 44 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 24 symbols, 0 fixed_strings, 60 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Point
+{
+  float x, y, z;
+  VIR_MAKE_REFLECTABLE(Point, x, y, z);
+};
+
+// resolved at compile time => must not leave any strings behind
+std::size_t
+data_member_index_z()
+{ return vir::refl::data_member_index<Point, "z">; }
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 28 symbols, 4 fixed_strings, 62 bytes .rodata
+// budget gcc -O2: 7 symbols, 4 fixed_strings, 19 bytes .rodata
+// budget clang -O0: 34 symbols, 4 fixed_strings, 78 bytes .rodata
+// budget clang -O2: 13 symbols, 4 fixed_strings, 35 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Point
+{
+  float x, y, z;
+  VIR_MAKE_REFLECTABLE(Point, x, y, z);
+};
+
+std::string_view
+data_member_name_runtime(std::size_t i)
+{
+  std::string_view r;
+  vir::refl::for_each_data_member_index<Point>([&](auto idx) {
+    if (idx == i)
+      r = vir::refl::data_member_name<Point, idx>;
+  });
+  return r;
+}
+
+const char*
+data_member_name_y()
+{ return vir::refl::data_member_name<Point, 1>.data(); }
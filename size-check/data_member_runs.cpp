@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 19 symbols, 0 fixed_strings, 304 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 25 symbols, 0 fixed_strings, 360 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+#include <cstring>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// one memcpy per run; with optimization nothing but the function remains
+void
+copy_trivial_members(Record& dst, const Record& src)
+{
+  [&]<std::size_t... Rs>(std::index_sequence<Rs...>) {
+    constexpr auto& runs = vir::refl::data_member_runs<Record>;
+    (std::memcpy(reinterpret_cast<char*>(&dst) + runs[Rs].offset,
+                 reinterpret_cast<const char*>(&src) + runs[Rs].offset, runs[Rs].size), ...);
+  }(std::make_index_sequence<vir::refl::data_member_runs<Record>.size()>());
+}
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 348 symbols, 0 fixed_strings, 193 bytes .rodata
+// budget gcc -O2: 24 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 415 symbols, 0 fixed_strings, 221 bytes .rodata
+// budget clang -O2: 30 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light-delta.h>
+
+struct State
+{
+  std::uint64_t id;
+  double x, y, z;
+  float gain;
+  std::string label;
+  VIR_MAKE_REFLECTABLE(State, id, x, y, z, gain, label);
+};
+
+std::bitset<6>
+changed(const State& prev, const State& state)
+{ return vir::refl::diff(prev, state); }
+
+std::size_t
+encode(const State& prev, const State& state, std::span<std::byte> buffer)
+{ return vir::refl::serialize_delta(prev, state, buffer); }
+
+std::size_t
+apply(State& state, std::span<const std::byte> buffer)
+{ return vir::refl::deserialize_delta(state, buffer); }
@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 14 symbols, 3 fixed_strings, 70 bytes .rodata
+// budget gcc -O2: 6 symbols, 3 fixed_strings, 46 bytes .rodata
+// budget clang -O0: 20 symbols, 3 fixed_strings, 86 bytes .rodata
+// budget clang -O2: 12 symbols, 3 fixed_strings, 62 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+namespace ns
+{
+  enum class Color
+  { Red, Green };
+}
+
+std::string_view
+enum_name_red()
+{ return vir::refl::enum_name<ns::Color::Red>; }
+
+const char*
+enum_name_green()
+{ return vir::refl::enum_name<ns::Color::Green>.data(); }
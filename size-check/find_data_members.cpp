@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 26 symbols, 0 fixed_strings, 72 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 32 symbols, 0 fixed_strings, 88 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Mixed
+{
+  int a;
+  float b;
+  int c;
+  double d;
+  VIR_MAKE_REFLECTABLE(Mixed, a, b, c, d);
+};
+
+template <typename T>
+  using is_int = std::is_same<T, int>;
+
+int
+sum_of_ints(const Mixed& m)
+{
+  int sum = 0;
+  [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    constexpr auto idx = vir::refl::find_data_members_by_type<Mixed, is_int>;
+    ((sum += vir::refl::data_member<idx[Is]>(m)), ...);
+  }(std::make_index_sequence<vir::refl::find_data_members_by_type<Mixed, is_int>.size()>());
+  return sum;
+}
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 24 symbols, 0 fixed_strings, 61 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 30 symbols, 0 fixed_strings, 77 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Point
+{
+  int id;
+  float x, y;
+  VIR_MAKE_REFLECTABLE(Point, id, x, y);
+};
+
+std::size_t
+floating_point_name_lengths()
+{
+  std::size_t n = 0;
+  vir::refl::for_each_data_member<Point>([&](auto member) {
+    if constexpr (member.template satisfies<std::is_floating_point>)
+      n += member.name.size();
+  });
+  return n;
+}
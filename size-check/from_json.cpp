@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 187 symbols, 0 fixed_strings, 332 bytes .rodata
+// budget gcc -O2: 31 symbols, 0 fixed_strings, 28 bytes .rodata
+// budget clang -O0: 223 symbols, 0 fixed_strings, 395 bytes .rodata
+// budget clang -O2: 37 symbols, 0 fixed_strings, 44 bytes .rodata
+
+#include <vir/reflect-light-json.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// the key lookup uses the name hash table of visit_data_member, no fixed_string objects
+bool
+read_record(std::string_view json, Record& r)
+{ return vir::refl::from_json(json, r); }
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 152 symbols, 0 fixed_strings, 168 bytes .rodata
+// budget gcc -O2: 5 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 181 symbols, 0 fixed_strings, 190 bytes .rodata
+// budget clang -O2: 11 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light-hash.h>
+
+// hashed as 16 bytes
+struct Key
+{
+  std::uint32_t run, lumi;
+  std::uint64_t event;
+  VIR_MAKE_REFLECTABLE(Key, run, lumi, event);
+};
+
+// hashed member-wise
+struct NamedKey
+{
+  std::string detector;
+  std::uint32_t channel;
+  std::uint16_t layer;
+  VIR_MAKE_REFLECTABLE(NamedKey, detector, channel, layer);
+};
+
+std::uint64_t
+hash_key(const Key& k)
+{ return vir::refl::hash(k); }
+
+std::size_t
+hash_named_key(const NamedKey& k)
+{ return vir::refl::hasher()(k); }
@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 14 symbols, 3 fixed_strings, 45 bytes .rodata
+// budget gcc -O2: 6 symbols, 3 fixed_strings, 21 bytes .rodata
+// budget clang -O0: 20 symbols, 3 fixed_strings, 61 bytes .rodata
+// budget clang -O2: 12 symbols, 3 fixed_strings, 37 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+std::string_view
+nttp_name_int()
+{ return vir::refl::nttp_name<42>; }
+
+std::string_view
+nttp_name_char()
+{ return vir::refl::nttp_name<'x'>; }
@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 19 symbols, 0 fixed_strings, 76 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 25 symbols, 0 fixed_strings, 92 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+#include <vector>
+
+struct Hit
+{
+  std::uint32_t channel;
+  float energy;
+  VIR_MAKE_REFLECTABLE(Hit, channel, energy);
+};
+
+struct Event
+{
+  std::uint64_t id;
+  std::vector<Hit> hits;
+  VIR_MAKE_REFLECTABLE(Event, id, hits);
+};
+
+struct Header
+{
+  std::uint64_t schema;
+  std::uint64_t size;
+};
+
+// the compatibility check is a single integer comparison, no strings are emitted
+bool
+compatible(const Header& header)
+{ return header.schema == vir::refl::schema_hash<Event>; }
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 219 symbols, 0 fixed_strings, 270 bytes .rodata
+// budget gcc -O2: 8 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 261 symbols, 0 fixed_strings, 317 bytes .rodata
+// budget clang -O2: 14 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light-serialize.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// three block copies (tag; id, x, y; t) and the string
+std::size_t
+write_record(const Record& r, std::span<std::byte> buffer)
+{ return vir::refl::serialize(r, buffer); }
+
+std::size_t
+read_record(Record& r, std::span<const std::byte> buffer)
+{ return vir::refl::deserialize(r, buffer); }
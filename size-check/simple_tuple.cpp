@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 24 symbols, 0 fixed_strings, 40 bytes .rodata
+// budget gcc -O2: 4 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 30 symbols, 0 fixed_strings, 56 bytes .rodata
+// budget clang -O2: 10 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+double
+simple_tuple_sum(const vir::simple_tuple<int, float, double>& t)
+{
+  double sum = 0;
+  t.for_each([&](auto x) { sum += x; });
+  return sum;
+}
+
+auto
+simple_tuple_tie(int& a, float& b)
+{ return vir::tie(a, b); }
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 445 symbols, 0 fixed_strings, 92 bytes .rodata
+// budget gcc -O2: 6 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 530 symbols, 0 fixed_strings, 108 bytes .rodata
+// budget clang -O2: 12 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/soa_vector.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// a loop over one column
+float
+sum_x(const vir::refl::soa_vector<Record>& v)
+{
+  float sum = 0;
+  for (float x : v.column<"x">())
+    sum += x;
+  return sum;
+}
+
+void
+add(vir::refl::soa_vector<Record>& v, const Record& r)
+{ v.push_back(r); }
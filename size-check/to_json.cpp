@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 109 symbols, 7 fixed_strings, 366 bytes .rodata
+// budget gcc -O2: 20 symbols, 7 fixed_strings, 253 bytes .rodata
+// budget clang -O0: 130 symbols, 7 fixed_strings, 436 bytes .rodata
+// budget clang -O2: 26 symbols, 7 fixed_strings, 296 bytes .rodata
+
+#include <vir/reflect-light-json.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// one fixed_string per key, e.g. {"tag": and ,"id":
+std::size_t
+write_record(const Record& r, std::span<char> buffer)
+{ return vir::refl::to_json(r, buffer); }
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 93 symbols, 0 fixed_strings, 160 bytes .rodata
+// budget gcc -O2: 9 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 111 symbols, 0 fixed_strings, 180 bytes .rodata
+// budget clang -O2: 15 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/tracked.h>
+
+struct Settings
+{
+  double cutoff, q;
+  float gain;
+  int taps;
+  VIR_MAKE_REFLECTABLE(Settings, cutoff, q, gain, taps);
+};
+
+void
+set_cutoff(vir::refl::tracked<Settings>& settings, double cutoff)
+{ settings.set<"cutoff">(cutoff); }
+
+double
+apply(vir::refl::tracked<Settings>& settings)
+{
+  double sum = 0;
+  settings.for_each_dirty([&](auto, auto value) { sum += value; });
+  settings.clear_dirty();
+  return sum;
+}
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 11 symbols, 0 fixed_strings, 40 bytes .rodata
+// budget gcc -O2: 3 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 17 symbols, 0 fixed_strings, 56 bytes .rodata
+// budget clang -O2: 9 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+namespace ns
+{
+  struct A
+  { int a; };
+
+  struct B
+  { float b; };
+}
+
+// type_id is a plain integer => dispatching on it needs no strings at all
+int
+dispatch(std::uint64_t id)
+{
+  switch (id)
+    {
+    case vir::refl::type_id<ns::A>:
+      return 1;
+    case vir::refl::type_id<ns::B>:
+      return 2;
+    default:
+      return 0;
+    }
+}
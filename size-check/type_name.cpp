@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 14 symbols, 3 fixed_strings, 52 bytes .rodata
+// budget gcc -O2: 6 symbols, 3 fixed_strings, 28 bytes .rodata
+// budget clang -O0: 20 symbols, 3 fixed_strings, 68 bytes .rodata
+// budget clang -O2: 12 symbols, 3 fixed_strings, 44 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+namespace ns
+{
+  struct Point
+  { float x, y; };
+}
+
+std::string_view
+type_name_point()
+{ return vir::refl::type_name<ns::Point>; }
+
+const char*
+type_name_int()
+{ return vir::refl::type_name<int>.data(); }
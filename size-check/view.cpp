@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 80 symbols, 0 fixed_strings, 171 bytes .rodata
+// budget gcc -O2: 4 symbols, 0 fixed_strings, 16 bytes .rodata
+// budget clang -O0: 96 symbols, 0 fixed_strings, 193 bytes .rodata
+// budget clang -O2: 10 symbols, 0 fixed_strings, 32 bytes .rodata
+
+#include <vir/reflect-light-serialize.h>
+
+struct Record
+{
+  char tag;
+  int id;
+  float x, y;
+  std::string name;
+  double t;
+  VIR_MAKE_REFLECTABLE(Record, tag, id, x, y, name, t);
+};
+
+// a load at a constant offset
+int
+read_id(std::span<const std::byte> buffer)
+{ return vir::refl::data_member<"id">(vir::refl::view<Record>(buffer)); }
+
+// a load behind the string
+double
+read_t(std::span<const std::byte> buffer)
+{ return vir::refl::data_member<"t">(vir::refl::view<Record>(buffer)); }
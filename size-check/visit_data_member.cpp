@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// budget gcc -O0: 81 symbols, 0 fixed_strings, 76 bytes .rodata
+// budget gcc -O2: 18 symbols, 0 fixed_strings, 36 bytes .rodata
+// budget clang -O0: 97 symbols, 0 fixed_strings, 92 bytes .rodata
+// budget clang -O2: 24 symbols, 0 fixed_strings, 52 bytes .rodata
+
+#include <vir/reflect-light.h>
+
+struct Settings
+{
+  int sample_rate;
+  float gain;
+  double delay;
+  VIR_MAKE_REFLECTABLE(Settings, sample_rate, gain, delay);
+};
+
+// hash tables + names + one function per data member
+bool
+apply_setting(Settings& s, std::string_view key, double value)
+{
+  return vir::refl::visit_data_member(s, key, [&](auto& member) {
+           member = static_cast<std::remove_reference_t<decltype(member)>>(value);
+         });
+}
+
+// one indirect call through a table of one function per data member
+void
+increment_field(Settings& s, std::size_t field)
+{ vir::refl::visit_data_member(s, field, [](auto& member) { member += 1; }); }
@@ -0,0 +1,595 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// test.cpp tests at compile time. The tests here cover what constant evaluation cannot reach:
+// the memcpy / offset-based code paths that are disabled in constant evaluation, and types that
+// are not usable in constant expressions.
+
+#include <vir/reflect-light-serialize.h>
+#include <vir/reflect-light-compare.h>
+#include <vir/reflect-light-delta.h>
+#include <vir/reflect-light-json.h>
+#include <vir/tracked.h>
+#include <vir/soa_vector.h>
+#include <vir/aosoa_vector.h>
+#include <vir/columnar_file.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(...)                                                                                 \
+  do {                                                                                             \
+    if (not (__VA_ARGS__))                                                                         \
+      {                                                                                            \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #__VA_ARGS__);      \
+        ++failures;                                                                                \
+      }                                                                                            \
+  } while (false)
+
+// an unlisted data member between a and b
+struct Hidden
+{
+  int a;
+  char hidden;
+  char b;
+  VIR_MAKE_REFLECTABLE(Hidden, a, b);
+};
+
+// listed in reverse declaration order
+struct Reordered
+{
+  int a, b;
+  VIR_MAKE_REFLECTABLE(Reordered, b, a);
+};
+
+struct Empty
+{
+  VIR_MAKE_REFLECTABLE(Empty);
+};
+
+struct WithEmpties
+{
+  std::vector<Empty> empties;
+  VIR_MAKE_REFLECTABLE(WithEmpties, empties);
+};
+
+template <typename T>
+  static T
+  round_trip(const T& obj)
+  {
+    std::vector<std::byte> buffer(vir::refl::serialized_size(obj));
+    CHECK(vir::refl::serialize(obj, buffer) == buffer.size());
+    T r = {};
+    CHECK(vir::refl::deserialize(r, buffer) == buffer.size());
+    return r;
+  }
+
+// d reuses the tail padding of the non-POD base (the data member offsets are not known)
+struct TailBase
+{
+  TailBase() = default;
+  TailBase(int x) : a(x), c() {}
+  int a;
+  char c;
+  VIR_MAKE_REFLECTABLE(TailBase, a, c);
+};
+
+struct ReusesTail : TailBase
+{
+  char d;
+  alignas(16) long double e;
+  VIR_MAKE_REFLECTABLE(ReusesTail, d, e);
+};
+
+static ReusesTail
+make_reuses_tail(int a, char c, char d, long double e)
+{
+  ReusesTail r;
+  r.a = a;
+  r.c = c;
+  r.d = d;
+  r.e = e;
+  return r;
+}
+
+struct PaddedArrays
+{
+  char c;
+  double x[2];
+  int m[2][3];
+  VIR_MAKE_REFLECTABLE(PaddedArrays, c, x, m);
+};
+
+static void
+test_serialize()
+{
+  const PaddedArrays arrays = round_trip(PaddedArrays {'a', {1.5, 2.5}, {{1, 2, 3}, {4, 5, 6}}});
+  CHECK(arrays.c == 'a' and arrays.x[1] == 2.5 and arrays.m[0][1] == 2 and arrays.m[1][2] == 6);
+
+  const ReusesTail t = round_trip(make_reuses_tail(1, 'c', 'd', 2.5L));
+  CHECK(t.a == 1 and t.c == 'c' and t.d == 'd' and t.e == 2.5L);
+  std::byte tail_buffer[64] = {};
+  CHECK(vir::refl::serialize(make_reuses_tail(7, 'c', 'd', 2.5L), tail_buffer) != 0);
+  int tail_a = 0;
+  std::memcpy(&tail_a, tail_buffer, sizeof(int));
+  CHECK(tail_a == 7);
+
+  const Hidden h = round_trip(Hidden {1, 'h', 'b'});
+  CHECK(h.a == 1 and h.b == 'b' and h.hidden == 0);
+
+  const Reordered p = round_trip(Reordered {1, 2});
+  CHECK(p.a == 1 and p.b == 2);
+
+  // serialized in list order: b, then a
+  std::byte buffer[8] = {};
+  CHECK(vir::refl::serialize(Reordered {1, 2}, buffer) == 8);
+  int first = 0;
+  std::memcpy(&first, buffer, sizeof(int));
+  CHECK(first == 2);
+
+  const vir::refl::view<Reordered> v(buffer);
+  CHECK(vir::refl::data_member<"b">(v) == 2 and vir::refl::data_member<"a">(v) == 1);
+
+  // a corrupt element count fails instead of looping, also if the elements need no bytes
+  std::uint64_t n = ~std::uint64_t();
+  std::memcpy(buffer, &n, sizeof(n));
+  WithEmpties r;
+  CHECK(vir::refl::deserialize(r, buffer) == 0);
+  n = 0;
+  std::memcpy(buffer, &n, sizeof(n));
+  CHECK(vir::refl::deserialize(r, buffer) == 8 and r.empties.empty());
+}
+
+// an unlisted data member between a and b of the same size as b
+struct Gap
+{
+  int a;
+  short hidden;
+  short b;
+  VIR_MAKE_REFLECTABLE(Gap, a, b);
+};
+
+static void
+test_compare()
+{
+  // memcmp blocks must not include the unlisted data member
+  CHECK(not vir::refl::equal(Gap {1, 5, 2}, Gap {1, 5, 3}));
+  CHECK(vir::refl::compare(Gap {1, 5, 2}, Gap {1, 5, 3}) < 0);
+  CHECK(vir::refl::equal(Gap {1, 5, 2}, Gap {1, 6, 2}));
+  CHECK(vir::refl::compare(Gap {1, 5, 2}, Gap {1, 6, 2}) == 0);
+  CHECK(vir::refl::compare(Gap {2, 5, 2}, Gap {1, 6, 3}) > 0);
+
+  CHECK(vir::refl::equal(Reordered {1, 2}, Reordered {1, 2}));
+  // b is compared first
+  CHECK(vir::refl::compare(Reordered {2, 1}, Reordered {1, 2}) < 0);
+}
+
+// listed out of declaration order, with a data member that is not trivially copyable
+struct Entity
+{
+  int id;
+  std::string name;
+  double x;
+  VIR_MAKE_REFLECTABLE(Entity, name, id, x);
+};
+
+static void
+test_delta()
+{
+  const Entity a {1, "a", 1.};
+  Entity b = a;
+  CHECK(vir::refl::diff(a, b).none());
+  b.id = 5;
+  b.x = -1.;
+  const std::bitset<3> changed = vir::refl::diff(a, b);
+  CHECK(changed == std::bitset<3>(0b110));
+
+  std::vector<std::byte> buffer(vir::refl::serialized_delta_size(b, changed));
+  CHECK(buffer.size() == 1 + 4 + 8);
+  CHECK(vir::refl::serialize_delta(b, changed, buffer) == buffer.size());
+  CHECK(vir::refl::serialize_delta(b, changed, std::span(buffer).first(buffer.size() - 1)) == 0);
+  std::vector<std::byte> buffer2(buffer.size());
+  CHECK(vir::refl::serialize_delta(a, b, buffer2) == buffer.size() and buffer2 == buffer);
+
+  Entity c = a;
+  std::bitset<3> read;
+  CHECK(vir::refl::deserialize_delta(c, buffer, read) == buffer.size());
+  CHECK(read == changed and c.id == 5 and c.x == -1. and c.name == "a");
+  CHECK(vir::refl::deserialize_delta(c, std::span(buffer).first(buffer.size() - 1)) == 0);
+
+  // a data member that is not trivially copyable
+  b.name = "a longer name than fits into the small string buffer";
+  CHECK(vir::refl::diff(c, b) == std::bitset<3>(0b001));
+  buffer.resize(vir::refl::serialized_delta_size(b, vir::refl::diff(c, b)));
+  CHECK(vir::refl::serialize_delta(c, b, buffer) == buffer.size());
+  CHECK(vir::refl::deserialize_delta(c, buffer) == buffer.size() and c.name == b.name);
+
+  // the unlisted data member is neither compared nor transferred
+  CHECK(vir::refl::diff(Hidden {1, 'x', 'b'}, Hidden {1, 'y', 'b'}).none());
+  CHECK(vir::refl::diff(Hidden {1, 'x', 'b'}, Hidden {1, 'x', 'c'}) == std::bitset<2>(0b10));
+  Hidden h {1, 'x', 'b'};
+  CHECK(vir::refl::serialize_delta(Hidden {1, 'x', 'b'}, Hidden {2, 'y', 'c'}, buffer) == 6);
+  CHECK(vir::refl::deserialize_delta(h, buffer) == 6 and h.a == 2 and h.hidden == 'x'
+          and h.b == 'c');
+
+  // the data members of a non-POD base whose tail padding is reused
+  const ReusesTail ta = make_reuses_tail(1, 'c', 'd', 2.5L);
+  ReusesTail tb = ta;
+  tb.a = 7;
+  tb.e = -1.L;
+  CHECK(vir::refl::diff(ta, tb) == std::bitset<4>(0b1001));
+  buffer.resize(64);
+  CHECK(vir::refl::serialize_delta(ta, tb, buffer) == 1 + 4 + sizeof(long double));
+  int delta_a = 0;
+  std::memcpy(&delta_a, buffer.data() + 1, sizeof(int));
+  CHECK(delta_a == 7);
+  ReusesTail tc = ta;
+  CHECK(vir::refl::deserialize_delta(tc, buffer) == 1 + 4 + sizeof(long double));
+  CHECK(tc.a == 7 and tc.c == 'c' and tc.d == 'd' and tc.e == -1.L);
+}
+
+static void
+test_tracked()
+{
+  vir::refl::tracked<Entity> t(Entity {1, "a", 1.});
+  CHECK(not t.any_dirty());
+  t.set<"id">(5);
+  CHECK(t.is_dirty<"id">() and not t.is_dirty<"name">() and t->id == 5);
+  int visited = 0;
+  t.for_each_dirty([&](auto idx, const auto& member) {
+    ++visited;
+    if constexpr (idx == 1)
+      CHECK(member == 5);
+    else
+      CHECK(false);
+  });
+  CHECK(visited == 1);
+
+  t.clear_dirty();
+  t.assign(Entity {5, "b", 2.});
+  CHECK(t.dirty() == std::bitset<3>(0b101) and t->name == "b" and t->x == 2.);
+  std::vector<std::string> names;
+  t.for_each_dirty([&](auto idx, const auto& member) {
+    if constexpr (idx == 0)
+      names.push_back(member);
+    else if constexpr (idx == 2)
+      names.push_back(std::to_string(member));
+  });
+  CHECK(names == std::vector<std::string> {"b", std::to_string(2.)});
+
+  t.clear_dirty();
+  t.data_member<"x">() = 3.;
+  CHECK(t.dirty() == std::bitset<3>(0b100) and t->x == 3.);
+
+  // the data members of a non-POD base whose tail padding is reused
+  vir::refl::tracked<ReusesTail> r(make_reuses_tail(1, 'c', 'd', 2.5L));
+  r.set<"a">(7);
+  r.assign([&] {
+    ReusesTail changed = r.value();
+    changed.e = -1.L;
+    return changed;
+  }());
+  CHECK(r.dirty() == std::bitset<4>(0b1001) and r->a == 7 and r->e == -1.L);
+  int sum = 0;
+  r.for_each_dirty([&](auto idx, const auto& member) {
+    if constexpr (idx == 0)
+      sum += member;
+    else if constexpr (idx == 3)
+      sum += int(member) * 100;
+    else
+      CHECK(false);
+  });
+  CHECK(sum == 7 - 100);
+}
+
+struct Particle
+{
+  float x, y;
+  std::string name;
+  VIR_MAKE_REFLECTABLE(Particle, x, y, name);
+};
+
+// counts its live objects and throws from the construction that brings throw_after to -1
+struct Counted
+{
+  static inline int live = 0;
+  static inline int throw_after = -1;
+
+  int value = 0;
+
+  static void
+  count()
+  {
+    if (throw_after == 0)
+      throw std::runtime_error("Counted");
+    if (throw_after > 0)
+      --throw_after;
+    ++live;
+  }
+
+  Counted()
+  { count(); }
+
+  Counted(const Counted& other)
+  : value(other.value)
+  { count(); }
+
+  Counted&
+  operator=(const Counted&) = default;
+
+  ~Counted()
+  { --live; }
+};
+
+struct Guarded
+{
+  Counted a;
+  std::string name;
+  Counted b;
+  VIR_MAKE_REFLECTABLE(Guarded, a, name, b);
+};
+
+static void
+test_soa_vector()
+{
+  vir::refl::soa_vector<Particle> v;
+  CHECK(v.empty() and v.capacity() == 0);
+  v.reserve(3);
+  CHECK(v.capacity() == 3 and v.empty());
+  for (int i = 0; i < 10; ++i)
+    v.push_back(Particle {float(i), float(-i), std::to_string(i)});
+  CHECK(v.size() == 10 and v.capacity() >= 10);
+  CHECK(Particle(v[7]).name == "7" and vir::refl::data_member<"y">(v[7]) == -7.f);
+  CHECK(v.column<"x">().size() == 10 and v.column<"x">()[6] == 6.f);
+  CHECK(v.column<2>()[9] == "9" and v.column<"y">().data() != nullptr);
+
+  // push_back of an element of the vector itself, also when the storage grows
+  while (v.size() != v.capacity())
+    v.push_back(v[0]);
+  const size_t n = v.size();
+  v.push_back(v[3]);
+  CHECK(v.size() == n + 1 and v.capacity() > n);
+  CHECK(Particle(v.back()).name == "3" and vir::refl::data_member<"x">(v.back()) == 3.f);
+  v.push_back(v.back());
+  CHECK(Particle(v.back()).name == "3");
+
+  vir::refl::soa_vector<Particle> copy = v;
+  v.pop_back();
+  CHECK(copy.size() == n + 2 and v.size() == n + 1 and Particle(copy[9]).name == "9");
+
+  v.resize(2);
+  CHECK(v.size() == 2 and Particle(v[1]).name == "1");
+  v.resize(5);
+  CHECK(v.size() == 5 and Particle(v[4]).name.empty() and v.column<"x">()[4] == 0.f);
+  v.clear();
+  CHECK(v.empty() and v.capacity() >= n + 1);
+
+  // a throwing reserve / resize leaves the vector unchanged and leaks nothing
+  {
+    vir::refl::soa_vector<Guarded> g(4);
+    g.column<"name">()[2] = "two";
+    g.column<"b">()[2].value = 2;
+    CHECK(Counted::live == 8);
+    const size_t capacity = g.capacity();
+    bool thrown = false;
+    Counted::throw_after = 6;
+    try
+      { g.reserve(100); }
+    catch (const std::runtime_error&)
+      { thrown = true; }
+    Counted::throw_after = -1;
+    CHECK(thrown and Counted::live == 8 and g.size() == 4 and g.capacity() == capacity);
+    CHECK(g.column<"name">()[2] == "two" and g.column<"b">()[2].value == 2);
+
+    // the reserve copies 8 Counted, then a is constructed and b throws
+    thrown = false;
+    Counted::throw_after = 8 + 4 + 2;
+    try
+      { g.resize(8); }
+    catch (const std::runtime_error&)
+      { thrown = true; }
+    Counted::throw_after = -1;
+    CHECK(thrown and Counted::live == 8 and g.size() == 4 and g.capacity() >= 8);
+    g.resize(8);
+    CHECK(Counted::live == 16 and g.column<"name">()[2] == "two");
+  }
+  CHECK(Counted::live == 0);
+}
+
+static void
+test_aosoa_vector()
+{
+  vir::refl::aosoa_vector<Particle, 4> v;
+  CHECK(v.empty() and v.capacity() == 0 and v.tile_count() == 0);
+  for (int i = 0; i < 10; ++i)
+    v.push_back(Particle {float(i), float(-i), std::to_string(i)});
+  CHECK(v.size() == 10 and v.capacity() % 4 == 0 and v.capacity() >= 10 and v.tile_count() == 3);
+  CHECK(Particle(v[7]).name == "7" and vir::refl::data_member<"y">(v[7]) == -7.f);
+  CHECK(v.column<"x">(1).size() == 4 and v.column<"x">(1)[2] == 6.f);
+  CHECK(v.column<0>(2).size() == 2 and v.column<"name">(2)[1] == "9");
+
+  // push_back of an element of the vector itself, also when the storage grows
+  while (v.size() != v.capacity())
+    v.push_back(v[0]);
+  const size_t n = v.size();
+  v.push_back(v[3]);
+  CHECK(v.size() == n + 1 and v.capacity() > n);
+  CHECK(Particle(v.back()).name == "3" and vir::refl::data_member<"x">(v.back()) == 3.f);
+  v.push_back(v.back());
+  CHECK(Particle(v.back()).name == "3");
+
+  vir::refl::aosoa_vector<Particle, 4> copy = v;
+  v.pop_back();
+  CHECK(copy.size() == n + 2 and v.size() == n + 1 and Particle(copy[9]).name == "9");
+  v[9] = Particle {1.f, 2.f, "nine"};
+  CHECK(Particle(copy[9]).name == "9" and Particle(v[9]).name == "nine");
+
+  int count = 0;
+  for (auto p : std::as_const(v))
+    count += vir::refl::data_member<"name">(p).empty();
+  CHECK(count == 0);
+
+  v.resize(2);
+  CHECK(v.size() == 2 and Particle(v[1]).name == "1");
+  v.resize(5);
+  CHECK(v.size() == 5 and Particle(v[4]).name.empty() and vir::refl::data_member<0>(v[4]) == 0.f);
+  v.clear();
+  CHECK(v.empty() and v.capacity() >= n + 1);
+
+  // a throwing reserve (Counted has no nothrow move, thus it is copied) leaves the vector
+  // unchanged and leaks nothing
+  {
+    vir::refl::aosoa_vector<Guarded, 4> g(4);
+    vir::refl::data_member<"name">(g[2]) = "two";
+    vir::refl::data_member<"b">(g[2]).value = 2;
+    CHECK(Counted::live == 8 and g.capacity() == 4);
+    bool thrown = false;
+    // element 2 throws after its data member a is constructed
+    Counted::throw_after = 2 + 2 + 1;
+    try
+      { g.reserve(100); }
+    catch (const std::runtime_error&)
+      { thrown = true; }
+    Counted::throw_after = -1;
+    CHECK(thrown and Counted::live == 8 and g.size() == 4 and g.capacity() == 4);
+    CHECK(Guarded(g[2]).name == "two" and vir::refl::data_member<"b">(g[2]).value == 2);
+    g.reserve(100);
+    CHECK(Counted::live == 8 and g.capacity() >= 100 and Guarded(g[2]).name == "two");
+  }
+  CHECK(Counted::live == 0);
+}
+
+struct TreeNode
+{
+  int value;
+  std::vector<TreeNode> children;
+  VIR_MAKE_REFLECTABLE(TreeNode, value, children);
+};
+
+static std::string
+nested_json(int depth)
+{
+  std::string json;
+  for (int i = 0; i < depth; ++i)
+    json += R"({"value": 1, "children": [)";
+  json += R"({"value": 2})";
+  for (int i = 0; i < depth; ++i)
+    json += "]}";
+  return json;
+}
+
+struct LongName
+{
+  int a_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_buffer;
+  int b;
+  VIR_MAKE_REFLECTABLE(LongName, a_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_buffer, b);
+};
+
+static void
+test_json()
+{
+  TreeNode tree {};
+  CHECK(vir::refl::from_json(nested_json(100), tree));
+  int depth = 0;
+  for (const TreeNode* node = &tree; not node->children.empty(); node = &node->children[0])
+    ++depth;
+  CHECK(depth == 100);
+
+  // every level is an object and an array; too deep nesting fails instead of overflowing the stack
+  CHECK(not vir::refl::from_json(nested_json(128), tree));
+  CHECK(not vir::refl::from_json(nested_json(1'000'000), tree));
+
+  // also in skipped values
+  CHECK(vir::refl::from_json(R"({"value": 3, "unknown": [[[[]]]]})", tree) and tree.value == 3);
+  std::string deep = R"({"unknown": )" + std::string(1'000'000, '[');
+  CHECK(not vir::refl::from_json(deep, tree));
+
+  // escaped keys are matched up to the length of the longest data member name
+  LongName l {};
+  CHECK(vir::refl::from_json(R"({"\u0061_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_buffer": 1, "\u0062": 2})", l));
+  CHECK(l.a_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_buffer == 1 and l.b == 2);
+  CHECK(vir::refl::from_json(R"({"\u0061_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_bufferx": 3})", l));
+  CHECK(l.a_data_member_name_that_is_longer_than_the_sixty_four_bytes_of_the_former_key_buffer == 1);
+}
+
+#ifdef VIR_HAVE_COLUMNAR_FILE
+struct Point
+{
+  double x;
+  float y;
+  std::uint16_t id;
+  VIR_MAKE_REFLECTABLE(Point, x, y, id);
+};
+
+static void
+test_columnar_file()
+{
+  const std::string path
+    = (std::filesystem::temp_directory_path() / "vir-reflect-light-test.col").string();
+
+  std::vector<Point> points;
+  for (int i = 0; i < 10000; ++i)
+    points.push_back({i * .5, float(-i), std::uint16_t(i)});
+  CHECK(vir::refl::write_columns(path.c_str(), points));
+  {
+    const vir::refl::columnar_file<Point> file(path.c_str());
+    CHECK(file.is_open() and file.size() == points.size() and not file.empty());
+    const std::span<const double> x = file.column<"x">();
+    CHECK(x.size() == points.size() and x[0] == 0. and x[9999] == 4999.5);
+    CHECK(reinterpret_cast<std::uintptr_t>(x.data()) % 64 == 0);
+    CHECK(file.column<2>()[1234] == 1234 and file.column<"y">()[5000] == -5000.f);
+    const Point p = file[4321];
+    CHECK(p.x == 2160.5 and p.y == -4321.f and p.id == 4321);
+
+    // a different type does not match the header
+    CHECK(not vir::refl::columnar_file<Reordered>(path.c_str()).is_open());
+  }
+
+  // no records
+  CHECK(vir::refl::write_columns(path.c_str(), std::vector<Point>()));
+  {
+    const vir::refl::columnar_file<Point> file(path.c_str());
+    CHECK(file.is_open() and file.empty() and file.column<"id">().empty());
+  }
+
+  // the columns of a soa_vector are written directly
+  vir::refl::soa_vector<Point> soa;
+  for (const Point& p : points)
+    soa.push_back(p);
+  CHECK(vir::refl::write_columns(path.c_str(), soa));
+  {
+    const vir::refl::columnar_file<Point> file(path.c_str());
+    CHECK(file.size() == points.size() and file.column<"y">()[17] == -17.f);
+    CHECK(file[9999].x == 4999.5 and file[9999].id == 9999);
+  }
+
+  std::filesystem::remove(path);
+  CHECK(not vir::refl::columnar_file<Point>(path.c_str()).is_open());
+}
+#endif
+
+int
+main()
+{
+  test_serialize();
+  test_compare();
+  test_delta();
+  test_tracked();
+  test_soa_vector();
+  test_aosoa_vector();
+  test_json();
+#ifdef VIR_HAVE_COLUMNAR_FILE
+  test_columnar_file();
+#endif
+  if (failures != 0)
+    std::fprintf(stderr, "%d checks failed\n", failures);
+  return failures != 0;
+}
@@ -4,10 +4,22 @@
  */
 
 #include <vir/reflect-light.h>
+#include <vir/reflect-light-serialize.h>
+#include <vir/reflect-light-schema.h>
+#include <vir/reflect-light-json.h>
+#include <vir/reflect-light-hash.h>
+#include <vir/reflect-light-compare.h>
+#include <vir/reflect-light-delta.h>
+#include <vir/soa_vector.h>
+#include <vir/aosoa_vector.h>
+#include <vir/vectorized.h>
+#include <vir/columnar_file.h>
+#include <vir/tracked.h>
 #include <vir/simple_tuple.h>
 #include <utility>
 #include <vector>
 #include <complex>
+#include <cstddef>
 #include <string>
 
 [[maybe_unused]] constexpr auto i0 = vir::refl::detail::ic<0>;
@@ -42,6 +54,18 @@ static_assert(std::tuple_size_v<vir::simple_tuple<int, float, char>> == 3);
 static_assert(std::same_as<std::tuple_element_t<0, vir::simple_tuple<int, float, char>>, int>);
 static_assert(std::same_as<std::tuple_element_t<1, vir::simple_tuple<int, float, char>>, float>);
 static_assert(std::same_as<std::tuple_element_t<2, vir::simple_tuple<int, float, char>>, char>);
+static_assert(std::same_as<vir::simple_tuple<const int, int&, int[2]>::type_at<0>, const int>);
+static_assert(std::same_as<vir::simple_tuple<const int, int&, int[2]>::type_at<1>, int&>);
+static_assert(std::same_as<vir::simple_tuple<const int, int&, int[2]>::type_at<2>, int[2]>);
+
+static_assert([] {
+  vir::simple_tuple t {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+  if (get<19>(t) != 19 or t[vir::refl::detail::ic<13>] != 13)
+    return false;
+  int sum = 0;
+  t.for_each([&](int x) { sum += x; });
+  return sum == 190 and t == t.transform([](int x) { return x; });
+}());
 
 static_assert([] {
   vir::simple_tuple t3{1, 2, 3};
@@ -250,6 +274,24 @@ static_assert(vir::refl::type_name<std::array<int, 4>> == "std::array<int, 4>");
 static_assert(vir::refl::type_name<std::vector<int>> == "std::vector<int>");
 static_assert(vir::refl::type_name<std::complex<float>> == "std::complex<float>");
 
+// FNV-1a of type_name<T>, i.e. the same value with every compiler
+static_assert(vir::refl::type_id<int> == 0x2b9fff192bd4c83eu);
+static_assert(vir::refl::type_id<float> == 0xa00a62a942b20165u);
+static_assert(vir::refl::type_id<std::string> == 0x2767bd747119cc57u);
+static_assert(vir::refl::type_id<std::vector<int>> == 0xf3bceda316ad7696u);
+static_assert(vir::refl::type_id<const int> != vir::refl::type_id<int>);
+static_assert([](std::uint64_t id) {
+                switch (id)
+                  {
+                  case vir::refl::type_id<int>:
+                    return 1;
+                  case vir::refl::type_id<float>:
+                    return 2;
+                  default:
+                    return 0;
+                  }
+              }(vir::refl::type_id<float>) == 2);
+
 namespace ns0
 {
   template <typename T, auto X>
@@ -281,6 +323,10 @@ namespace ns0
   static_assert(vir::refl::type_name<Enum> == "ns0::Enum");
   static_assert(vir::refl::type_name<EnumClass> == "ns0::EnumClass");
 
+  static_assert(vir::refl::type_id<NotReflected<int, 5>> == 0x2f08a37ce38aa857u);
+  static_assert(vir::refl::type_id<Foo<int>> == 0x7c6fa343f60d07d3u);
+  static_assert(vir::refl::type_id<EnumClass> == 0x5169613e3bf7ee69u);
+
   static_assert(vir::refl::enum_name<A> == "ns0::A");
   static_assert(vir::refl::enum_name<B> == "ns0::B");
   static_assert(vir::refl::enum_name<C> == "ns0::C");
@@ -311,6 +357,9 @@ static_assert(std::same_as<vir::refl::data_member_type<Test, 2>, int>);
 static_assert(std::same_as<vir::refl::data_member_type<Test, "a">, int>);
 static_assert(std::same_as<vir::refl::data_member_type<Test, "b">, int>);
 static_assert(std::same_as<vir::refl::data_member_type<Test, "foo">, int>);
+static_assert(vir::refl::data_member_index<Test, "a"> == 0);
+static_assert(vir::refl::data_member_index<Test, "b"> == 1);
+static_assert(vir::refl::data_member_index<Test, "foo"> == 2);
 
 static_assert([] {
   Test t {1, 2, 3};
@@ -368,6 +417,11 @@ static_assert(std::same_as<vir::refl::data_member_type<Derived, "b">, int>);
 static_assert(std::same_as<vir::refl::data_member_type<Derived, "foo">, int>);
 static_assert(std::same_as<vir::refl::data_member_type<Derived, "in">, float>);
 static_assert(std::same_as<vir::refl::data_member_type<Derived, "out">, double>);
+static_assert(vir::refl::data_member_index<Derived, "a"> == 0);
+static_assert(vir::refl::data_member_index<Derived, "foo"> == 2);
+static_assert(vir::refl::data_member_index<Derived, "in"> == 3);
+static_assert(vir::refl::data_member_index<Derived, "out"> == 4);
+static_assert(vir::refl::data_member_index<Derived, vir::fixed_string("out")> == 4);
 
 static_assert([] {
   Derived t {{1, 2, 3}, 1.1f, 2.2};
@@ -406,9 +460,36 @@ static_assert([] {
   if (&vir::refl::all_data_members(t)[i4] != &t.out)
     return false;
 
+  const Derived& ct = t;
+  if (&vir::refl::all_data_members(ct)[i0] != &t.a)
+    return false;
+  if (&vir::refl::all_data_members(ct)[i4] != &t.out)
+    return false;
+
   return true;
 }());
 
+// more data members than VIR_MAKE_REFLECTABLE handles without recursion
+struct Large
+{
+  int m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19,
+      m20, m21, m22, m23, m24, m25, m26, m27, m28, m29, m30, m31, m32, m33, m34, m35, m36, m37,
+      m38, m39, m40, m41, m42, m43, m44, m45, m46, m47, m48, m49, m50, m51, m52, m53, m54, m55,
+      m56, m57, m58, m59, m60, m61, m62, m63, m64, m65, m66, m67, m68, m69;
+  VIR_MAKE_REFLECTABLE(Large, m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14,
+                       m15, m16, m17, m18, m19, m20, m21, m22, m23, m24, m25, m26, m27, m28,
+                       m29, m30, m31, m32, m33, m34, m35, m36, m37, m38, m39, m40, m41, m42,
+                       m43, m44, m45, m46, m47, m48, m49, m50, m51, m52, m53, m54, m55, m56,
+                       m57, m58, m59, m60, m61, m62, m63, m64, m65, m66, m67, m68, m69);
+};
+
+static_assert(vir::refl::data_member_count<Large> == 70);
+static_assert(vir::refl::data_member_name<Large, 0> == "m0");
+static_assert(vir::refl::data_member_name<Large, 32> == "m32");
+static_assert(vir::refl::data_member_name<Large, 69> == "m69");
+static_assert(vir::refl::data_member_index<Large, "m64"> == 64);
+static_assert(std::same_as<vir::refl::data_member_type<Large, 69>, int>);
+
 struct Further : Derived
 {
   char c;
@@ -429,6 +510,40 @@ struct AndAnother : Further
 static_assert(vir::refl::reflectable<AndAnother>);
 static_assert(std::same_as<vir::refl::base_type<AndAnother>, Further>);
 
+struct ExplicitRoot
+{
+  int x;
+  VIR_MAKE_REFLECTABLE_WITH_BASE(ExplicitRoot, void, x);
+};
+
+struct ExplicitDerived : Further
+{
+  short s;
+  VIR_MAKE_REFLECTABLE_WITH_BASE(ExplicitDerived, Further, s);
+};
+
+// discovers the explicitly declared base via the friend functions
+struct ImplicitAfterExplicit : ExplicitDerived
+{
+  VIR_MAKE_REFLECTABLE(ImplicitAfterExplicit);
+};
+
+static_assert(std::same_as<vir::refl::base_type<ExplicitRoot>, void>);
+static_assert(vir::refl::data_member_count<ExplicitRoot> == 1);
+static_assert(std::same_as<vir::refl::base_type<ExplicitDerived>, Further>);
+static_assert(vir::refl::data_member_count<ExplicitDerived> == 7);
+static_assert(vir::refl::data_member_name<ExplicitDerived, 6> == "s");
+static_assert(vir::refl::data_member_index<ExplicitDerived, "c"> == 5);
+static_assert(std::same_as<vir::refl::base_type<ImplicitAfterExplicit>, ExplicitDerived>);
+static_assert(vir::refl::data_member_count<ImplicitAfterExplicit> == 7);
+
+// the explicit base must be the nearest reflectable base (naming Derived or void would lose data
+// members)
+static_assert(vir::refl::detail::is_nearest_base<ExplicitDerived, Further>());
+static_assert(not vir::refl::detail::is_nearest_base<ExplicitDerived, Derived>());
+static_assert(not vir::refl::detail::is_nearest_base<ExplicitDerived, void>());
+static_assert(vir::refl::detail::is_nearest_base<ExplicitRoot, void>());
+
 template <typename T, size_t Idx>
 using only_floats = std::is_same<vir::refl::data_member_type<T, Idx>, float>;
 
@@ -520,3 +635,574 @@ string_test2()
 const char*
 member_name_string0()
 { return vir::refl::data_member_name<ns::Type<char>, 0>.data(); }
+
+// data member offsets and memcpy-able runs
+struct Padded
+{
+  char c;
+  int i;
+  short s, t;
+  std::string str;
+  double d, e;
+  VIR_MAKE_REFLECTABLE(Padded, c, i, s, t, str, d, e);
+};
+
+static_assert(vir::refl::data_member_offset<Padded, 0> == offsetof(Padded, c));
+static_assert(vir::refl::data_member_offset<Padded, 1> == offsetof(Padded, i));
+static_assert(vir::refl::data_member_offset<Padded, "t"> == offsetof(Padded, t));
+static_assert(vir::refl::data_member_offset<Padded, "str"> == offsetof(Padded, str));
+static_assert(vir::refl::data_member_offset<Padded, 6> == offsetof(Padded, e));
+static_assert(vir::refl::data_member_runs<Padded>.size() == 3);
+static_assert(vir::refl::data_member_runs<Padded>[0] == vir::refl::data_member_run {0, 1, 0, 1});
+static_assert(vir::refl::data_member_runs<Padded>[1] == vir::refl::data_member_run {1, 3, 4, 8});
+static_assert(vir::refl::data_member_runs<Padded>[2]
+                == vir::refl::data_member_run {5, 2, offsetof(Padded, d), 16});
+
+// inherited data members: Test::foo and Derived::in are contiguous
+static_assert(vir::refl::data_member_offset<Derived, "foo"> == 8);
+static_assert(vir::refl::data_member_offset<Derived, "in"> == 12);
+static_assert(vir::refl::data_member_offset<Derived, "out"> == 16);
+static_assert(vir::refl::data_member_runs<Derived>.size() == 1);
+static_assert(vir::refl::data_member_runs<Derived>[0] == vir::refl::data_member_run {0, 5, 0, 24});
+static_assert(vir::refl::data_member_offset<ns::Type2, 0> == 0);
+static_assert(vir::refl::data_member_runs<Type3>[0] == vir::refl::data_member_run {0, 4, 0, 16});
+
+// offsets do not depend on unlisted data members or the order of the list
+struct Hidden
+{
+  int a;
+  char hidden;
+  char b;
+  VIR_MAKE_REFLECTABLE(Hidden, a, b);
+};
+
+static_assert(vir::refl::data_member_offset<Hidden, 1> == 5);
+static_assert(vir::refl::data_member_runs<Hidden>.size() == 2);
+static_assert(vir::refl::data_member_runs<Hidden>[1] == vir::refl::data_member_run {1, 1, 5, 1});
+static_assert(not vir::refl::detail::bytewise<Hidden>);
+
+struct Reordered
+{
+  int a, b;
+  VIR_MAKE_REFLECTABLE(Reordered, b, a);
+};
+
+static_assert(vir::refl::data_member_offset<Reordered, "b"> == 4);
+static_assert(vir::refl::data_member_offset<Reordered, "a"> == 0);
+static_assert(vir::refl::data_member_runs<Reordered>.size() == 2);
+
+// the position of the base class subobject is ambiguous (0, 1, 2, or 3)
+struct SmallBase
+{
+  char c;
+  VIR_MAKE_REFLECTABLE(SmallBase, c);
+};
+
+struct AfterSmallBase : SmallBase
+{
+  int i;
+  VIR_MAKE_REFLECTABLE(AfterSmallBase, i);
+};
+
+static_assert(not vir::refl::detail::checked_layout<AfterSmallBase>().valid);
+
+// d reuses the tail padding of the non-POD base: the base subobject is at 0, but would also fit
+// at 8
+struct TailBase
+{
+  TailBase() = default;
+  TailBase(int x) : a(x), c() {}
+  int a;
+  char c;
+  VIR_MAKE_REFLECTABLE(TailBase, a, c);
+};
+
+struct ReusesTail : TailBase
+{
+  char d;
+  alignas(16) long double e;
+  VIR_MAKE_REFLECTABLE(ReusesTail, d, e);
+};
+
+static_assert(offsetof(ReusesTail, d) < sizeof(TailBase));
+static_assert(vir::refl::detail::checked_layout<TailBase>().valid);
+static_assert(not vir::refl::detail::checked_layout<ReusesTail>().valid);
+
+// schema fingerprints: class name, data member names and types, nested schemas
+template <int Version>
+  struct Versioned;
+
+template <>
+  struct Versioned<1>
+  {
+    int a, b, foo;
+    VIR_MAKE_REFLECTABLE(Versioned, a, b, foo);
+  };
+
+template <>
+  struct Versioned<2>
+  {
+    int a, b, foo;
+    VIR_MAKE_REFLECTABLE(Versioned, a, b, foo);
+  };
+
+template <>
+  struct Versioned<3>
+  {
+    int a, b, bar;
+    VIR_MAKE_REFLECTABLE(Versioned, a, b, bar);
+  };
+
+template <>
+  struct Versioned<4>
+  {
+    int a, b;
+    float foo;
+    VIR_MAKE_REFLECTABLE(Versioned, a, b, foo);
+  };
+
+template <int Version>
+  struct Envelope
+  {
+    std::vector<Versioned<Version>> items;
+    VIR_MAKE_REFLECTABLE(Envelope, items);
+  };
+
+struct TreeNode
+{
+  int value;
+  std::vector<TreeNode> children;
+  VIR_MAKE_REFLECTABLE(TreeNode, value, children);
+};
+
+static_assert(vir::refl::schema_hash<Test> == 0x266206c5b3b625b9u);
+static_assert(vir::refl::schema_hash<Versioned<1>> == vir::refl::schema_hash<Versioned<2>>);
+static_assert(vir::refl::schema_hash<Versioned<1>> != vir::refl::schema_hash<Versioned<3>>);
+static_assert(vir::refl::schema_hash<Versioned<1>> != vir::refl::schema_hash<Versioned<4>>);
+static_assert(vir::refl::schema_hash<Envelope<1>> != vir::refl::schema_hash<Envelope<3>>);
+static_assert(vir::refl::schema_hash<Derived> != vir::refl::schema_hash<Test>);
+static_assert(vir::refl::schema_hash<TreeNode> != 0);
+
+// runtime name -> data member dispatch
+static_assert([] {
+  Derived d {{1, 2, 3}, 4.f, 5.};
+  double sum = 0;
+  auto add = [&](auto x) { sum += x; };
+  for (std::string_view name : {"a", "b", "foo", "in", "out"})
+    if (not vir::refl::visit_data_member(d, name, add))
+      return false;
+  if (sum != 15)
+    return false;
+  if (vir::refl::visit_data_member(d, "fo", add) or vir::refl::visit_data_member(d, "outt", add)
+        or vir::refl::visit_data_member(d, "", add) or vir::refl::visit_data_member(d, "c", add))
+    return false;
+  vir::refl::visit_data_member(d, "in", [](auto& x) { x = 8; });
+  return d.in == 8.f and sum == 15;
+}());
+
+static_assert([] {
+  Large l = {};
+  bool ok = true;
+  vir::refl::for_each_data_member_index<Large>([&](auto idx) {
+    ok = ok and vir::refl::visit_data_member(l, vir::refl::data_member_name<Large, idx>, [&](int& x) {
+                  ok = ok and &x == &vir::refl::data_member<idx>(l);
+                });
+  });
+  return ok and not vir::refl::visit_data_member(l, "m70", [](int) {});
+}());
+
+struct Shadowing : Test
+{
+  short a;
+  VIR_MAKE_REFLECTABLE(Shadowing, a);
+};
+
+// like data_member_index, the name refers to the first data member of that name
+static_assert([] {
+  Shadowing s = {};
+  return vir::refl::visit_data_member(s, "a", [](auto& x) { x = 1; }) and s.Test::a == 1
+           and s.a == 0;
+}());
+
+// runtime index -> data member dispatch
+static_assert([] {
+  Derived d {{1, 2, 3}, 4.f, 5.};
+  double sum = 0;
+  for (std::size_t i = 0; i < vir::refl::data_member_count<Derived>; ++i)
+    sum += vir::refl::visit_data_member(d, i, [](auto x) -> double { return x; });
+  vir::refl::visit_data_member(d, 3, [](auto& x) { x = 8; });
+  const Derived& cd = d;
+  return sum == 15 and d.in == 8.f
+           and vir::refl::visit_data_member(cd, 1, [](const auto& x) { return sizeof(x); }) == 4;
+}());
+
+// binary serialization
+struct Message
+{
+  Derived head;
+  std::vector<Test> items;
+  std::vector<std::string> tags;
+  Padded padded;
+  VIR_MAKE_REFLECTABLE(Message, head, items, tags, padded);
+};
+
+static_assert(vir::refl::detail::serial_raw<Derived>);
+static_assert(vir::refl::detail::serial_raw<Type3>);
+static_assert(not vir::refl::detail::serial_raw<Padded>);
+static_assert(not vir::refl::detail::serial_raw<Message>);
+static_assert(vir::refl::detail::serial_blocks<Padded>
+                == std::array<std::size_t, 7> {1, 8, 0, 0, 0, 16, 0});
+
+static_assert([] {
+  Padded p {'x', 1, 2, 3, "hello", 4., 5.};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(p));
+  if (buffer.size() != 1 + 4 + 2 + 2 + 8 + 5 + 8 + 8
+        or vir::refl::serialize(p, buffer) != buffer.size()
+        or vir::refl::serialize(p, std::span(buffer).first(buffer.size() - 1)) != 0)
+    return false;
+  Padded q = {};
+  if (vir::refl::deserialize(q, std::span(buffer).first(buffer.size() - 1)) != 0)
+    return false;
+  q = {};
+  return vir::refl::deserialize(q, buffer) == buffer.size() and q.c == 'x' and q.i == 1
+           and q.s == 2 and q.t == 3 and q.str == "hello" and q.d == 4. and q.e == 5.;
+}());
+
+static_assert([] {
+  Message m {{{1, 2, 3}, 4.f, 5.}, {{6, 7, 8}, {9, 10, 11}}, {"a", "", "bc"},
+                   {'y', 12, 13, 14, "", 15., 16.}};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(m) + 3);
+  const std::size_t n = vir::refl::serialize(m, buffer);
+  if (n != 24 + 8 + 2 * 12 + 8 + 3 * 8 + 3 + 1 + 4 + 2 + 2 + 8 + 8 + 8)
+    return false;
+  Message r = {};
+  r.items.resize(5);
+  r.tags = {"x"};
+  if (vir::refl::deserialize(r, buffer) != n)
+    return false;
+  return r.head.a == 1 and r.head.foo == 3 and r.head.out == 5. and r.items.size() == 2
+           and r.items[1].b == 10 and r.tags == std::vector<std::string> {"a", "", "bc"}
+           and r.padded.c == 'y' and r.padded.str.empty() and r.padded.e == 16.;
+}());
+
+// array data members of a padded class are read member-wise
+struct PaddedArrays
+{
+  char c;
+  double x[2];
+  int m[2][3];
+  VIR_MAKE_REFLECTABLE(PaddedArrays, c, x, m);
+};
+
+static_assert(not vir::refl::detail::serial_raw<PaddedArrays>);
+static_assert([] {
+  PaddedArrays a {'a', {1.5, 2.5}, {{1, 2, 3}, {4, 5, 6}}};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(a));
+  vir::refl::serialize(a, buffer);
+  PaddedArrays r = {};
+  return vir::refl::deserialize(r, buffer) == buffer.size() and r.c == 'a' and r.x[0] == 1.5
+           and r.x[1] == 2.5 and r.m[0][0] == 1 and r.m[1][2] == 6;
+}());
+
+// a corrupt element count fails without allocating
+static_assert([] {
+  Message m {};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(m));
+  vir::refl::serialize(m, buffer);
+  buffer[24] = std::byte(0xff);
+  buffer[31] = std::byte(0x7f);
+  Message r = {};
+  return vir::refl::deserialize(r, buffer) == 0;
+}());
+
+// views of serialized objects
+static_assert(vir::refl::detail::serial_fixed_size<Derived> == 24);
+static_assert(vir::refl::detail::serial_fixed_size<Message>
+                == vir::refl::detail::serial_dynamic_size);
+
+static_assert([] {
+  Message m {{{1, 2, 3}, 4.f, 5.}, {{6, 7, 8}, {9, 10, 11}}, {"a", "", "bc"},
+             {'y', 12, 13, 14, "xyz", 15., 16.}};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(m) + 5);
+  const std::size_t n = vir::refl::serialize(m, buffer);
+  const vir::refl::view<Message> v(buffer);
+  const auto head = vir::refl::data_member<0>(v);
+  const auto items = vir::refl::data_member<"items">(v);
+  const auto tags = vir::refl::data_member<"tags">(v);
+  const auto padded = vir::refl::data_member<"padded">(v);
+  return std::same_as<decltype(head), const Derived> and head.out == 5. and items.size() == 2
+           and items[1].b == 10 and items[0].foo == 8 and tags.size() == 3 and not tags.empty()
+           and tags.bytes().size() == 8 + 3 * 8 + 3 and vir::refl::data_member<"c">(padded) == 'y'
+           and vir::refl::data_member<3>(padded) == 14
+           and vir::refl::data_member<"e">(padded) == 16.
+           and padded.bytes().size() == 1 + 4 + 2 + 2 + 8 + 3 + 8 + 8 and v.bytes().size() == n;
+}());
+
+// the encoding follows the list order, not the declaration order
+static_assert(not vir::refl::detail::serial_raw<Reordered>);
+
+static_assert([] {
+  std::vector<std::byte> buffer(vir::refl::serialized_size(Reordered {1, 2}));
+  vir::refl::serialize(Reordered {1, 2}, buffer);
+  const vir::refl::view<Reordered> v(buffer);
+  return vir::refl::data_member<"b">(v) == 2 and vir::refl::data_member<"a">(v) == 1
+           and vir::refl::data_member<0>(v) == 2;
+}());
+
+// hashing: objects without padding and of unique object representation are hashed as bytes
+static_assert(vir::refl::detail::bytewise<Test>);
+static_assert(not vir::refl::detail::bytewise<Derived>); // float and double
+static_assert(not vir::refl::detail::bytewise<Padded>);
+static_assert(vir::refl::hash(Test {1, 2, 3}) == vir::refl::hash(Test {1, 2, 3}));
+static_assert(vir::refl::hash(Test {1, 2, 3}) != vir::refl::hash(Test {1, 3, 2}));
+static_assert(vir::refl::hash(Derived {{1, 2, 3}, 0.f, -0.})
+                == vir::refl::hash(Derived {{1, 2, 3}, -0.f, 0.}));
+static_assert(vir::refl::hash(Derived {{1, 2, 3}, 4.f, 5.})
+                != vir::refl::hash(Derived {{1, 2, 3}, 5.f, 4.}));
+static_assert([] {
+  Message m {{{1, 2, 3}, 4.f, 5.}, {{6, 7, 8}, {9, 10, 11}}, {"a", "", "bc"},
+             {'y', 12, 13, 14, "a string with more than 32 characters", 15., 16.}};
+  Message m2 = m;
+  if (vir::refl::hash(m) != vir::refl::hash(m2))
+    return false;
+  m2.tags[1] = "b";
+  Message m3 = m;
+  m3.items.pop_back();
+  return vir::refl::hash(m) != vir::refl::hash(m2) and vir::refl::hash(m) != vir::refl::hash(m3)
+           and vir::refl::hasher()(m) == vir::refl::hash(m)
+           and std::hash<Message>()(m) == vir::refl::hash(m);
+}());
+static_assert(std::is_default_constructible_v<std::hash<Test>>);
+
+// comparison: bytewise data members that are consecutive in index order and memory form one block
+static_assert(vir::refl::detail::compare_blocks<Padded, vir::refl::detail::iota_array<7>>
+                == std::array<std::size_t, 7> {1, 8, 0, 0, 0, 0, 0});
+static_assert(vir::refl::detail::compare_blocks<Padded, std::array<std::size_t, 3> {3, 2, 1}>
+                == std::array<std::size_t, 3> {2, 2, 4});
+static_assert(vir::refl::detail::compare_blocks<Test, std::array<std::size_t, 2> {1, 2}>
+                == std::array<std::size_t, 2> {8, 0});
+static_assert(vir::refl::detail::compare_blocks<Hidden, vir::refl::detail::iota_array<2>>
+                == std::array<std::size_t, 2> {4, 1});
+static_assert(vir::refl::detail::compare_blocks<Reordered, vir::refl::detail::iota_array<2>>
+                == std::array<std::size_t, 2> {4, 4});
+static_assert(std::same_as<decltype(vir::refl::compare(Padded(), Padded())),
+                           std::partial_ordering>);
+static_assert(std::same_as<decltype(vir::refl::compare_by<std::array<std::size_t, 2> {4, 1}>(
+                                      Padded(), Padded())), std::strong_ordering>);
+static_assert([] {
+  Padded a {'x', 1, 2, 3, "hello", 4., 5.};
+  Padded b = a;
+  if (not vir::refl::equal(a, b) or vir::refl::compare(a, b) != 0)
+    return false;
+  b.e = 6.;
+  b.t = 2;
+  constexpr std::array<std::size_t, 3> key = {0, 1, 2};
+  return not vir::refl::equal(a, b) and vir::refl::compare(a, b) > 0
+           and vir::refl::equal_by<key>(a, b) and vir::refl::compare_by<key>(a, b) == 0
+           and vir::refl::compare_by<std::array<std::size_t, 1> {6}>(a, b) < 0;
+}());
+static_assert([] {
+  Message m {{{1, 2, 3}, 4.f, 5.}, {{6, 7, 8}, {9, 10, 11}}, {"a", "", "bc"},
+             {'y', 12, 13, 14, "", 15., 16.}};
+  Message m2 = m;
+  m2.items[1].foo = 12;
+  return vir::refl::equal(m, m) and not vir::refl::equal(m, m2) and vir::refl::compare(m, m2) < 0;
+}());
+
+// JSON keys are compile-time constants
+static_assert(vir::refl::detail::json_key<Test, 0> == "{\"a\":");
+static_assert(vir::refl::detail::json_key<Test, 2> == ",\"foo\":");
+static_assert(vir::refl::detail::json_key<Derived, 3> == ",\"in\":");
+
+// soa_vector element references are reflectable like the element type (with flattened bases)
+static_assert(vir::refl::reflectable<vir::refl::soa_reference<Derived>>);
+static_assert(std::same_as<vir::refl::base_type<vir::refl::soa_reference<Derived>>, void>);
+static_assert(vir::refl::data_member_count<vir::refl::soa_reference<Derived>> == 5);
+static_assert(vir::refl::data_member_name<vir::refl::soa_reference<Derived>, 0> == "a");
+static_assert(vir::refl::data_member_name<vir::refl::soa_reference<Derived, true>, 4> == "out");
+static_assert(vir::refl::data_member_index<vir::refl::soa_reference<Derived>, "in"> == 3);
+static_assert(std::same_as<vir::refl::data_member_type<vir::refl::soa_reference<Derived>, "out">,
+                           double>);
+static_assert([] {
+  int a = 1, b = 2, foo = 3;
+  float in = 4;
+  double out = 5;
+  const vir::simple_tuple<int*, int*, int*, float*, double*> columns {&a, &b, &foo, &in, &out};
+  const vir::refl::soa_reference<Derived> r(columns, 0);
+  vir::refl::data_member<"foo">(r) = 8;
+  const Derived d = r;
+  const vir::refl::soa_reference<Derived, true> cr = r;
+  return foo == 8 and d.foo == 8 and d.out == 5.
+           and &vir::refl::data_member<"in">(cr) == &in
+           and std::same_as<decltype(vir::refl::data_member<"in">(cr)), const float&>;
+}());
+
+// aosoa_vector tiles: W values per data member, the smallest arithmetic type fills a register
+static_assert(vir::refl::detail::native_tile_width<Derived>
+                == vir::refl::detail::simd_register_bytes / sizeof(int));
+static_assert(vir::refl::detail::aosoa_layout<Derived, 4>.offsets[3] == 48);
+static_assert(vir::refl::detail::aosoa_layout<Derived, 4>.offsets[4] == 64);
+static_assert(vir::refl::detail::aosoa_layout<Derived, 4>.bytes == 96);
+static_assert(vir::refl::detail::aosoa_layout<Derived, 1>.bytes == 32);
+static_assert(vir::refl::reflectable<vir::refl::aosoa_reference<Derived, 4>>);
+static_assert(std::same_as<vir::refl::base_type<vir::refl::aosoa_reference<Derived, 4>>, void>);
+static_assert(vir::refl::data_member_count<vir::refl::aosoa_reference<Derived, 4, true>> == 5);
+static_assert(vir::refl::data_member_index<vir::refl::aosoa_reference<Derived, 4>, "in"> == 3);
+static_assert(std::same_as<decltype(vir::refl::data_member<"out">(
+                             std::declval<vir::refl::aosoa_reference<Derived, 4, true>>())),
+                           const double&>);
+
+#ifdef VIR_HAVE_VECTORIZED
+// vectorized<T, N> has the data members of T, widened to SIMD vectors
+static_assert(vir::refl::reflectable<vir::refl::vectorized<Derived, 4>>);
+static_assert(std::same_as<vir::refl::base_type<vir::refl::vectorized<Derived, 4>>, void>);
+static_assert(vir::refl::data_member_count<vir::refl::vectorized<Derived, 4>> == 5);
+static_assert(vir::refl::data_member_name<vir::refl::vectorized<Derived, 4>, 2> == "foo");
+static_assert(vir::refl::data_member_index<vir::refl::vectorized<Derived, 4>, "out"> == 4);
+static_assert(std::same_as<vir::refl::data_member_type<vir::refl::vectorized<Derived, 4>, "in">,
+                           vir::refl::detail::simd_of<float, 4>>);
+static_assert(vir::refl::vectorized<Derived>::size == vir::refl::aosoa_vector<Derived>::tile_width);
+static_assert(std::same_as<decltype(vir::refl::data_member<"a">(
+                             std::declval<const vir::refl::vectorized<Derived, 4>&>())),
+                           const vir::refl::detail::simd_of<int, 4>&>);
+#endif
+
+// columnar files: the header describes the columns, which start at multiples of 64 bytes
+static_assert([] {
+  const auto schema = vir::refl::detail::columnar_schema_of<Derived>(10);
+  return schema.class_name == "Derived" and schema.members.size() == 5
+           and schema.members[3].name == "in" and schema.members[3].type == "float"
+           and schema.members[4].size == 8 and schema.members[0].offset % 64 == 0
+           and schema.members[4].offset == schema.members[3].offset + 64
+           and vir::refl::detail::columnar_file_size(schema) == schema.members[4].offset + 80;
+}());
+static_assert([] {
+  const auto schema = vir::refl::detail::columnar_schema_of<Derived>(10);
+  std::vector<std::byte> file(vir::refl::detail::columnar_file_size(schema));
+  vir::refl::serialize(schema, file);
+  std::uint64_t count = 0;
+  std::array<std::size_t, 5> offsets = {};
+  std::array<std::size_t, 3> test_offsets = {};
+  return vir::refl::detail::columnar_check<Derived>(file, count, offsets) and count == 10
+           and offsets[4] == schema.members[4].offset
+           and not vir::refl::detail::columnar_check<Derived>(
+                     std::span(file).first(file.size() - 1), count, offsets)
+           and not vir::refl::detail::columnar_check<Test>(file, count, test_offsets);
+}());
+
+// schema evolution: data members are matched by name, removed ones skipped, added ones defaulted
+template <int Version>
+  struct Evolving;
+
+template <>
+  struct Evolving<1>
+  {
+    int id;
+    std::string name;
+    double x;
+    std::vector<short> removed;
+    VIR_MAKE_REFLECTABLE(Evolving, id, name, x, removed);
+  };
+
+template <>
+  struct Evolving<2>
+  {
+    double x;
+    int id;
+    float added = 1;
+    std::string name;
+    VIR_MAKE_REFLECTABLE(Evolving, x, id, added, name);
+  };
+
+template <>
+  struct Evolving<3>
+  {
+    float id;
+    VIR_MAKE_REFLECTABLE(Evolving, id);
+  };
+
+static_assert(vir::refl::schema_of<Evolving<1>>().members[3].type
+              == vir::refl::type_name<std::vector<short>>.view());
+static_assert(vir::refl::schema_of<Evolving<1>>().members[3].element_size == sizeof(short));
+static_assert(vir::refl::schema_of<Evolving<1>>().members[2].size == sizeof(double));
+static_assert([] {
+  const vir::refl::record_schema stored = vir::refl::schema_of<Evolving<1>>();
+  const vir::refl::schema_loader<Evolving<2>> loader(stored);
+  Evolving<1> old {3, "abc", 1.5, {1, 2, 3}};
+  std::vector<std::byte> buffer(vir::refl::serialized_size(old));
+  vir::refl::serialize(old, buffer);
+  Evolving<2> obj {0, 0, 7, "x"};
+  return loader.valid() and loader.load(obj, buffer) == buffer.size() and obj.x == 1.5
+           and obj.id == 3 and obj.added == 1 and obj.name == "abc"
+           and loader.load(obj, std::span(buffer).first(buffer.size() - 1)) == 0
+           and not vir::refl::schema_loader<Evolving<3>>(stored).valid();
+}());
+// a data member whose type_name is unchanged but whose structure changed is not decoded
+static_assert(vir::refl::schema_of<Evolving<1>>().members[3].type_hash
+                != vir::refl::schema_of<Evolving<1>>().members[1].type_hash);
+static_assert([] {
+  vir::refl::record_schema stored = vir::refl::schema_of<Evolving<1>>();
+  stored.members[1].type_hash ^= 1;
+  return vir::refl::schema_loader<Evolving<1>>(stored).valid() == false
+           and vir::refl::schema_loader<Evolving<2>>(stored).valid() == false
+           and vir::refl::schema_loader<Evolving<2>>(vir::refl::schema_of<Evolving<1>>()).valid();
+}());
+
+// delta encoding: only the data members that differ are stored, float / double by their bits
+struct State
+{
+  int id;
+  double x, y;
+  std::string label;
+  std::vector<float> taps;
+  VIR_MAKE_REFLECTABLE(State, id, x, y, label, taps);
+};
+
+static_assert([] {
+  State a {1, 0., 2., "a", {1.f, 2.f}};
+  State b = a;
+  b.x = -0.;
+  b.taps[1] = 3.f;
+  return vir::refl::detail::diff_mask(a, a)[0] == 0
+           and vir::refl::detail::diff_mask(a, b)[0] == 0b10010u;
+}());
+
+static_assert([] {
+  State a {1, 0., 2., "a", {1.f, 2.f}};
+  State b {1, 0., 5., "abc", {1.f, 2.f}};
+  std::array<std::byte, 64> buffer = {};
+  vir::refl::detail::serial_writer out {buffer.data(), buffer.data() + buffer.size()};
+  if (not vir::refl::detail::serialize_delta_members(out, b, vir::refl::detail::diff_mask(a, b)))
+    return false;
+  // 1 byte header, 8 bytes y, 8 + 3 bytes label
+  const std::size_t size = std::size_t(out.ptr - buffer.data());
+  vir::refl::detail::serial_reader in {buffer.data(), buffer.data() + size};
+  vir::refl::detail::delta_mask<State> mask = {};
+  State c = a;
+  bool ok = size == 20 and vir::refl::detail::deserialize_delta_members(in, c, mask)
+              and in.ptr == in.end and mask[0] == 0b01100u and c.y == 5. and c.label == "abc";
+  // a header with a bit of a data member State does not have
+  buffer[0] = std::byte(0b100000);
+  vir::refl::detail::serial_reader bad {buffer.data(), buffer.data() + size};
+  return ok and not vir::refl::detail::deserialize_delta_members(bad, c, mask);
+}());
+
+// dirty tracking: write accessors mark data members, value() does not
+static_assert([] {
+  vir::refl::tracked<State> t(State {1, 0., 2., "a", {1.f}});
+  bool ok = not t.any_dirty() and t->y == 2.;
+  t.set<"x">(1.5);
+  t.data_member<4>().push_back(2.f);
+  ok = ok and t.value().x == 1.5 and t->taps.size() == 2 and t.is_dirty<"x">()
+         and t.is_dirty<"taps">() and not t.is_dirty<0>() and t.any_dirty();
+  std::size_t visited = 0;
+  t.for_each_dirty([&](auto idx, const auto& member) {
+    if constexpr (idx == 1)
+      ok = ok and member == 1.5;
+    visited = visited * 10 + idx;
+  });
+  t.clear_dirty();
+  ok = ok and visited == 14 and not t.any_dirty();
+  t.assign(State {1, 1.5, 3., "a", {1.f, 2.f}});
+  return ok and t.is_dirty<"y">() and not t.is_dirty<"x">() and not t.is_dirty<"taps">();
+}());
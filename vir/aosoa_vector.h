@@ -0,0 +1,532 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_AOSOA_VECTOR_H_
+#define VIR_AOSOA_VECTOR_H_
+
+#include "soa_vector.h"
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // The size of the SIMD registers of the target (in bytes).
+    inline constexpr size_t simd_register_bytes =
+#if defined __AVX512F__
+      64;
+#elif defined __AVX__
+      32;
+#else
+      16;
+#endif
+
+    // The number of values of the smallest arithmetic (or enum) data member type of T that fit
+    // into one SIMD register. 1 if T has no such data member.
+    template <typename T>
+      constexpr size_t native_tile_width = [] {
+        size_t smallest = simd_register_bytes;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((smallest = (std::is_arithmetic_v<data_member_type<T, Is>>
+                          or std::is_enum_v<data_member_type<T, Is>>)
+                         and sizeof(data_member_type<T, Is>) < smallest
+                         ? sizeof(data_member_type<T, Is>) : smallest), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return simd_register_bytes / smallest;
+      }();
+
+    // The offsets of the W values of each data member of T inside a tile, and the size and
+    // alignment of a tile. bytes is a multiple of alignment, thus all tiles of an array of tiles
+    // are aligned.
+    template <size_t N>
+      struct tile_layout
+      {
+        size_t offsets[N];
+        size_t bytes;
+        size_t alignment;
+      };
+
+    template <typename T, size_t W>
+      constexpr tile_layout<data_member_count<T>> aosoa_layout = [] {
+        tile_layout<data_member_count<T>> r = {};
+        r.alignment = simd_register_bytes;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((r.bytes = align_up(r.bytes, alignof(data_member_type<T, Is>)),
+            r.offsets[Is] = r.bytes,
+            r.bytes += W * sizeof(data_member_type<T, Is>),
+            r.alignment = r.alignment < alignof(data_member_type<T, Is>)
+                            ? alignof(data_member_type<T, Is>) : r.alignment), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        r.bytes = align_up(r.bytes, r.alignment);
+        return r;
+      }();
+  }
+
+  // A reference to the element of an aosoa_vector<T, W>. Like soa_reference, it is reflectable
+  // with the same data members (names and types) as T, flattening the base classes of T.
+  template <reflectable T, size_t W, bool Const = false>
+    class aosoa_reference
+    {
+      static constexpr const auto& tile = detail::aosoa_layout<T, W>;
+
+      std::byte* tile_;
+      size_t lane_;
+
+    public:
+      using value_type = T;
+
+      using vir_refl_explicit_base = detail::explicit_base<aosoa_reference, void>;
+
+      using vir_refl_data_member_types = typename detail::soa_types<T>::members;
+
+      static constexpr std::integral_constant<size_t, data_member_count<T>>
+        vir_refl_data_member_count {};
+
+      static constexpr auto vir_refl_data_member_names = detail::soa_types<T>::names;
+
+      // References the element at index in the array of tiles starting at tiles.
+      aosoa_reference(std::byte* tiles, size_t index)
+      : tile_(tiles + index / W * tile.bytes), lane_(index % W)
+      {}
+
+      // a reference can be converted to a const reference (lane_ < W, thus tile_ is unchanged)
+      operator aosoa_reference<T, W, true>() const requires (not Const)
+      { return {tile_, lane_}; }
+
+      auto
+      vir_refl_members_as_tuple() const
+      {
+        using R = std::conditional_t<Const, typename detail::soa_types<T>::const_references,
+                                     typename detail::soa_types<T>::references>;
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+          return R {reinterpret_cast<data_member_type<T, Is>*>(tile_ + tile.offsets[Is])
+                      [lane_]...};
+        }(std::make_index_sequence<data_member_count<T>>());
+      }
+
+      // Returns a copy of the element.
+      operator T() const
+      {
+        T obj {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(obj) = data_member<Is>(*this)), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return obj;
+      }
+
+      // Assigns all data members of obj to the element.
+      const aosoa_reference&
+      operator=(const T& obj) const requires (not Const)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(*this) = data_member<Is>(obj)), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return *this;
+      }
+    };
+
+  // A sequence container of T objects, which stores the elements in tiles of W elements. A tile
+  // holds W values of the first data member of T (including those of base classes), followed by W
+  // values of the second data member, and so on. Thus, W consecutive values of one data member can
+  // be loaded into a SIMD register, while all data members of an element are close to each other
+  // in memory. W defaults to the number of values of the smallest arithmetic data member type that
+  // fit into a SIMD register of the target. All tiles share a single allocation.
+  template <reflectable T, size_t W = detail::native_tile_width<T>>
+    class aosoa_vector
+    {
+      static constexpr size_t N = data_member_count<T>;
+
+      static_assert(N != 0, "aosoa_vector<T> requires T to have data members");
+
+      static_assert(W != 0, "aosoa_vector<T, W> requires a tile width W > 0");
+
+      static_assert([]<size_t... Is>(std::index_sequence<Is...>) {
+                      return (not std::is_array_v<data_member_type<T, Is>> and ...);
+                    }(std::make_index_sequence<N>()),
+                    "aosoa_vector<T> does not support array data members; use std::array");
+
+      static constexpr auto indexes = std::make_index_sequence<N>();
+
+      static constexpr const auto& tile = detail::aosoa_layout<T, W>;
+
+      template <size_t Idx>
+        using column_type = data_member_type<T, Idx>;
+
+      std::byte* tiles_ = nullptr;
+      size_t size_ = 0;
+      size_t capacity_ = 0;
+
+      // The data member Idx of the element at index i in the array of tiles starting at tiles.
+      template <size_t Idx>
+        static column_type<Idx>*
+        member_pointer(std::byte* tiles, size_t i)
+        {
+          return reinterpret_cast<column_type<Idx>*>(tiles + i / W * tile.bytes
+                                                       + tile.offsets[Idx]) + i % W;
+        }
+
+      void
+      deallocate()
+      {
+        if (capacity_ != 0)
+          ::operator delete(tiles_, std::align_val_t(tile.alignment));
+      }
+
+      static void
+      destroy_elements(std::byte* tiles, size_t first, size_t last)
+      {
+        for (size_t i = first; i < last; ++i)
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::destroy_at(member_pointer<Is>(tiles, i)), ...);
+          }(indexes);
+      }
+
+      void
+      destroy_range(size_t first, size_t last)
+      { destroy_elements(tiles_, first, last); }
+
+      // Destroys the data members [0, constructed) of the element at index in tiles on
+      // destruction.
+      struct construction_guard
+      {
+        std::byte* tiles;
+        size_t index;
+        size_t constructed = 0;
+
+        ~construction_guard()
+        {
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((Is < constructed ? std::destroy_at(member_pointer<Is>(tiles, index)) : void()),
+             ...);
+          }(indexes);
+        }
+      };
+
+      // Destroys the elements [0, constructed) in tiles and deallocates tiles on destruction,
+      // unless dismissed (tiles == nullptr).
+      struct allocation_guard
+      {
+        std::byte* tiles;
+        size_t constructed = 0;
+
+        ~allocation_guard()
+        {
+          if (tiles != nullptr)
+            {
+              destroy_elements(tiles, 0, constructed);
+              ::operator delete(tiles, std::align_val_t(tile.alignment));
+            }
+        }
+      };
+
+      // reserve moves the elements to the new tiles only if no move constructor can throw (or if
+      // a data member cannot be copied). Otherwise it copies them, thus a throwing reserve leaves
+      // *this unchanged (as std::vector does).
+      static constexpr bool move_on_reserve = []<size_t... Is>(std::index_sequence<Is...>) {
+        return (std::is_nothrow_move_constructible_v<column_type<Is>> and ...)
+                 or not (std::is_copy_constructible_v<column_type<Is>> and ...);
+      }(indexes);
+
+      template <typename Obj>
+        void
+        construct_back(Obj&& obj)
+        {
+          construction_guard guard {tiles_, size_};
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((std::construct_at(member_pointer<Is>(tiles_, size_), [&]() -> decltype(auto) {
+                if constexpr (std::is_lvalue_reference_v<Obj>)
+                  return data_member<Is>(obj);
+                else
+                  return std::move(data_member<Is>(obj));
+              }()), ++guard.constructed), ...);
+          }(indexes);
+          guard.constructed = 0;
+          ++size_;
+        }
+
+      template <typename Obj>
+        void
+        grow_and_construct_back(Obj&& obj)
+        {
+          if (size_ == capacity_)
+            reserve(capacity_ == 0 ? (W < 8 ? 8 : W) : 2 * capacity_);
+          construct_back(static_cast<Obj&&>(obj));
+        }
+
+    public:
+      using value_type = T;
+      using size_type = size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference = aosoa_reference<T, W>;
+      using const_reference = aosoa_reference<T, W, true>;
+
+      // The number of elements per tile.
+      static constexpr size_t tile_width = W;
+
+      template <bool Const>
+        class basic_iterator
+        {
+          std::byte* tiles_ = nullptr;
+          size_t index_ = 0;
+
+          friend aosoa_vector;
+
+          basic_iterator(std::byte* tiles, size_t index)
+          : tiles_(tiles), index_(index)
+          {}
+
+        public:
+          using value_type = T;
+          using difference_type = std::ptrdiff_t;
+          using reference = aosoa_reference<T, W, Const>;
+          using iterator_category = std::input_iterator_tag;
+
+          basic_iterator() = default;
+
+          reference
+          operator*() const
+          { return {tiles_, index_}; }
+
+          basic_iterator&
+          operator++()
+          {
+            ++index_;
+            return *this;
+          }
+
+          basic_iterator
+          operator++(int)
+          { return {tiles_, index_++}; }
+
+          friend bool
+          operator==(const basic_iterator&, const basic_iterator&) = default;
+        };
+
+      using iterator = basic_iterator<false>;
+      using const_iterator = basic_iterator<true>;
+
+      aosoa_vector() = default;
+
+      explicit
+      aosoa_vector(size_t n)
+      { resize(n); }
+
+      aosoa_vector(const aosoa_vector& other)
+      {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+          push_back(other[i]);
+      }
+
+      aosoa_vector(aosoa_vector&& other) noexcept
+      : tiles_(std::exchange(other.tiles_, nullptr)), size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0))
+      {}
+
+      aosoa_vector&
+      operator=(const aosoa_vector& other)
+      {
+        if (this != &other)
+          {
+            aosoa_vector copy(other);
+            swap(copy);
+          }
+        return *this;
+      }
+
+      aosoa_vector&
+      operator=(aosoa_vector&& other) noexcept
+      {
+        aosoa_vector moved(std::move(other));
+        swap(moved);
+        return *this;
+      }
+
+      ~aosoa_vector()
+      {
+        clear();
+        deallocate();
+      }
+
+      void
+      swap(aosoa_vector& other) noexcept
+      {
+        std::swap(tiles_, other.tiles_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+      }
+
+      // capacity
+      size_t
+      size() const
+      { return size_; }
+
+      // Always a multiple of W.
+      size_t
+      capacity() const
+      { return capacity_; }
+
+      bool
+      empty() const
+      { return size_ == 0; }
+
+      // Allocates memory for all tiles in one block, if n exceeds capacity(). If moving or
+      // copying an element throws, *this is unchanged (see move_on_reserve).
+      void
+      reserve(size_t n)
+      {
+        if (n <= capacity_)
+          return;
+        const size_t tiles = (n + W - 1) / W;
+        allocation_guard allocation {static_cast<std::byte*>(
+                                       ::operator new(tiles * tile.bytes,
+                                                      std::align_val_t(tile.alignment)))};
+        for (; allocation.constructed < size_; ++allocation.constructed)
+          {
+            const size_t i = allocation.constructed;
+            construction_guard guard {allocation.tiles, i};
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+              ((std::construct_at(member_pointer<Is>(allocation.tiles, i),
+                                  [&]() -> decltype(auto) {
+                                    if constexpr (move_on_reserve)
+                                      return std::move(*member_pointer<Is>(tiles_, i));
+                                    else
+                                      return std::as_const(*member_pointer<Is>(tiles_, i));
+                                  }()), ++guard.constructed), ...);
+            }(indexes);
+            guard.constructed = 0;
+          }
+        destroy_range(0, size_);
+        deallocate();
+        tiles_ = std::exchange(allocation.tiles, nullptr);
+        capacity_ = tiles * W;
+      }
+
+      // Value-initializes new elements or destroys the elements at the end.
+      void
+      resize(size_t n)
+      {
+        if (n < size_)
+          {
+            destroy_range(n, size_);
+            size_ = n;
+            return;
+          }
+        reserve(n);
+        for (; size_ < n; ++size_)
+          {
+            construction_guard guard {tiles_, size_};
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+              ((std::construct_at(member_pointer<Is>(tiles_, size_)), ++guard.constructed), ...);
+            }(indexes);
+            guard.constructed = 0;
+          }
+      }
+
+      void
+      clear()
+      {
+        destroy_range(0, size_);
+        size_ = 0;
+      }
+
+      // modifiers
+      void
+      push_back(const T& obj)
+      { grow_and_construct_back(obj); }
+
+      void
+      push_back(T&& obj)
+      { grow_and_construct_back(std::move(obj)); }
+
+      // obj may reference an element of *this, which reserve moves. Thus, copy it first if the
+      // storage grows.
+      void
+      push_back(const_reference obj)
+      {
+        if (size_ == capacity_)
+          grow_and_construct_back(T(obj));
+        else
+          construct_back(obj);
+      }
+
+      void
+      push_back(reference obj)
+      { push_back(const_reference(obj)); }
+
+      void
+      pop_back()
+      {
+        --size_;
+        destroy_range(size_, size_ + 1);
+      }
+
+      // element access
+      reference
+      operator[](size_t i)
+      { return {tiles_, i}; }
+
+      const_reference
+      operator[](size_t i) const
+      { return {tiles_, i}; }
+
+      reference
+      front()
+      { return (*this)[0]; }
+
+      const_reference
+      front() const
+      { return (*this)[0]; }
+
+      reference
+      back()
+      { return (*this)[size_ - 1]; }
+
+      const_reference
+      back() const
+      { return (*this)[size_ - 1]; }
+
+      iterator
+      begin()
+      { return {tiles_, 0}; }
+
+      iterator
+      end()
+      { return {tiles_, size_}; }
+
+      const_iterator
+      begin() const
+      { return {tiles_, 0}; }
+
+      const_iterator
+      end() const
+      { return {tiles_, size_}; }
+
+      // tile access
+      size_t
+      tile_count() const
+      { return (size_ + W - 1) / W; }
+
+      // The contiguous values of the data member given by index or name in tile t, e.g.
+      // column<"x">(t). The span has W elements, except for the last tile, which only holds the
+      // remaining size() - t * W elements.
+      template <detail::data_member_id Id>
+        std::span<column_type<detail::member_index<T, Id>>>
+        column(size_t t)
+        {
+          return {member_pointer<detail::member_index<T, Id>>(tiles_, t * W),
+                  size_ - t * W < W ? size_ - t * W : W};
+        }
+
+      template <detail::data_member_id Id>
+        std::span<const column_type<detail::member_index<T, Id>>>
+        column(size_t t) const
+        {
+          return {member_pointer<detail::member_index<T, Id>>(tiles_, t * W),
+                  size_ - t * W < W ? size_ - t * W : W};
+        }
+    };
+}
+
+#endif  // VIR_AOSOA_VECTOR_H_
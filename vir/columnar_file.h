@@ -0,0 +1,375 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_COLUMNAR_FILE_H_
+#define VIR_COLUMNAR_FILE_H_
+
+#include "reflect-light-schema.h"
+#include "soa_vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// write_columns and columnar_file require POSIX (pwrite and mmap). Without it, only the header
+// format in namespace detail is declared and VIR_HAVE_COLUMNAR_FILE is not defined.
+#if __has_include(<sys/mman.h>) and __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VIR_HAVE_COLUMNAR_FILE 1
+#endif
+
+// A file format storing a sequence of reflectable T objects column by column: all values of the
+// first data member, followed by all values of the second data member, etc.
+//
+// The file starts with a header (the serialize encoding of detail::columnar_schema): a magic
+// number, a byte order mark, the number of records, class_name<T>, and for every data member its
+// name, type_name, size, and the file offset of its column. Every column starts at a multiple of
+// 64 bytes. As with serialize, values use the native representation.
+//
+// columnar_file<T> maps a file into memory and returns its columns as std::span without copying.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    struct columnar_member
+    {
+      std::string name;
+      std::string type;
+      std::uint64_t size;
+      std::uint64_t offset;
+
+      VIR_MAKE_REFLECTABLE(columnar_member, name, type, size, offset);
+
+      friend constexpr bool
+      operator==(const columnar_member&, const columnar_member&) = default;
+    };
+
+    struct columnar_schema
+    {
+      std::array<char, 8> magic;
+      std::uint64_t byte_order;
+      std::uint64_t count;
+      std::string class_name;
+      std::vector<columnar_member> members;
+
+      VIR_MAKE_REFLECTABLE(columnar_schema, magic, byte_order, count, class_name, members);
+
+      friend constexpr bool
+      operator==(const columnar_schema&, const columnar_schema&) = default;
+    };
+
+    inline constexpr std::array<char, 8> columnar_magic
+      = {'v', 'i', 'r', 'c', 'o', 'l', 's', '1'};
+
+    inline constexpr std::uint64_t columnar_byte_order = 0x0102030405060708u;
+
+    inline constexpr size_t columnar_alignment = 64;
+
+    // The data members of T can be stored as columns (and T has data members).
+    template <typename T>
+      constexpr bool columnar_storable = data_member_count<T> != 0 and [] {
+        return []<size_t... Is>(std::index_sequence<Is...>) {
+          return ((std::is_trivially_copyable_v<data_member_type<T, Is>>
+                     and not std::is_pointer_v<data_member_type<T, Is>>
+                     and not std::is_array_v<data_member_type<T, Is>>) and ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+      }();
+
+    // The header of a file with count T objects. The header size does not depend on count, thus
+    // the column offsets follow from the size of the header.
+    template <typename T>
+      constexpr columnar_schema
+      columnar_schema_of(std::uint64_t count)
+      {
+        std::string_view strings = schema_strings<T>.view();
+        const auto next = [&](size_t n) {
+          std::string str(strings.substr(0, n));
+          strings.remove_prefix(n);
+          return str;
+        };
+        columnar_schema schema {columnar_magic, columnar_byte_order, count,
+                                next(class_name<T>.size()), {}};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((schema.members.push_back({next(data_member_name<T, Is>.size()),
+                                      next(type_name<data_member_type<T, Is>>.size()),
+                                      sizeof(data_member_type<T, Is>), 0})), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        std::uint64_t offset = serialized_size(schema);
+        for (columnar_member& member : schema.members)
+          {
+            member.offset = align_up(offset, columnar_alignment);
+            offset = member.offset + count * member.size;
+          }
+        return schema;
+      }
+
+    // The size of a file with count T objects.
+    constexpr std::uint64_t
+    columnar_file_size(const columnar_schema& schema)
+    {
+      const columnar_member& last = schema.members.back();
+      return last.offset + schema.count * last.size;
+    }
+
+    // Checks that file starts with the header of a file of T objects and that all columns are
+    // inside of file. On success, returns true and sets count and the column offsets.
+    template <typename T>
+      constexpr bool
+      columnar_check(std::span<const std::byte> file, std::uint64_t& count,
+                     std::array<size_t, data_member_count<T>>& offsets)
+      {
+        columnar_schema schema;
+        if (deserialize(schema, file) == 0 or schema.magic != columnar_magic
+              or schema.byte_order != columnar_byte_order)
+          return false;
+        // a corrupt count could overflow in the computation of the column offsets
+        if (schema.count > file.size())
+          return false;
+        if (schema != columnar_schema_of<T>(schema.count)
+              or columnar_file_size(schema) > file.size())
+          return false;
+        count = schema.count;
+        for (size_t i = 0; i < offsets.size(); ++i)
+          offsets[i] = schema.members[i].offset;
+        return true;
+      }
+
+#ifdef VIR_HAVE_COLUMNAR_FILE
+    // Writes n bytes at offset, continuing after partial writes.
+    inline bool
+    write_at(int fd, const void* data, size_t n, std::uint64_t offset)
+    {
+      const auto* ptr = static_cast<const std::byte*>(data);
+      while (n > 0)
+        {
+          const ssize_t written = ::pwrite(fd, ptr, n, off_t(offset));
+          if (written == -1 and errno == EINTR)
+            continue;
+          if (written <= 0)
+            return false;
+          ptr += written;
+          n -= size_t(written);
+          offset += size_t(written);
+        }
+      return true;
+    }
+
+    // Writes a file with count T objects to fd, where get_column(ic<Idx>, first, n) returns a
+    // pointer to the values of data member Idx of the objects [first, first + n). The objects are
+    // processed in blocks of the given size, with all columns of a block written before the next
+    // block (i.e. an array of structures is read only once). The bytes between the columns are
+    // not written, which leaves them zero.
+    template <typename T>
+      bool
+      write_columns(int fd, size_t count, size_t block, auto&& get_column)
+      {
+        const columnar_schema schema = columnar_schema_of<T>(count);
+        {
+          // the header and the padding up to the first column
+          std::vector<std::byte> header(schema.members[0].offset);
+          serialize(schema, header);
+          if (not write_at(fd, header.data(), header.size(), 0))
+            return false;
+        }
+        for (size_t first = 0; first < count; first += block)
+          {
+            const size_t n = std::min(block, count - first);
+            const bool written = [&]<size_t... Is>(std::index_sequence<Is...>) {
+              return (write_at(fd, get_column(ic<Is>, first, n),
+                               n * sizeof(data_member_type<T, Is>),
+                               schema.members[Is].offset + first * sizeof(data_member_type<T, Is>))
+                        and ...);
+            }(std::make_index_sequence<data_member_count<T>>());
+            if (not written)
+              return false;
+          }
+        return true;
+      }
+
+    template <typename T>
+      bool
+      write_columns_to(const char* path, size_t count, size_t block, auto&& get_column)
+      {
+        static_assert(columnar_storable<T>,
+                      "vir::refl::write_columns requires all data members of T to be trivially "
+                      "copyable (and not pointers or arrays)");
+        const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1)
+          return false;
+        const bool written = write_columns<T>(fd, count, block, get_column);
+        return ::close(fd) == 0 and written;
+      }
+#endif  // VIR_HAVE_COLUMNAR_FILE
+  }
+
+#ifdef VIR_HAVE_COLUMNAR_FILE
+
+  // Writes records to the file at path (overwriting it) in the columnar format (see above).
+  // Returns false if the file cannot be written.
+  template <reflectable T>
+    bool
+    write_columns(const char* path, std::span<const T> records)
+    {
+      // the records of a block stay in the cache while their data members are gathered
+      constexpr size_t block = 4096;
+      std::vector<std::byte> buffer(block * []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::max({sizeof(data_member_type<T, Is>)...});
+      }(std::make_index_sequence<data_member_count<T>>()));
+      return detail::write_columns_to<T>(
+               path, records.size(), block,
+               [&]<size_t Idx>(std::integral_constant<size_t, Idx>, size_t first, size_t n) {
+                 using M = data_member_type<T, Idx>;
+                 for (size_t i = 0; i < n; ++i)
+                   std::memcpy(buffer.data() + i * sizeof(M),
+                               std::addressof(data_member<Idx>(records[first + i])), sizeof(M));
+                 return buffer.data();
+               });
+    }
+
+  template <reflectable T, typename A>
+    bool
+    write_columns(const char* path, const std::vector<T, A>& records)
+    { return write_columns(path, std::span<const T>(records)); }
+
+  // soa_vector stores the columns already, i.e. they are written without copying.
+  template <reflectable T>
+    bool
+    write_columns(const char* path, const soa_vector<T>& records)
+    {
+      return detail::write_columns_to<T>(
+               path, records.size(), records.size(),
+               [&]<size_t Idx>(std::integral_constant<size_t, Idx>, size_t first, size_t) {
+                 return records.template column<Idx>().data() + first;
+               });
+    }
+
+  // A read-only memory mapping of a file written by write_columns. column<"name">() and
+  // column<Idx>() return the values of a data member of all records as std::span, pointing into
+  // the mapping (i.e. only the pages of the columns that are accessed are read from disk).
+  template <reflectable T>
+    class columnar_file
+    {
+      static constexpr size_t N = data_member_count<T>;
+
+      static_assert(detail::columnar_storable<T>,
+                    "columnar_file<T> requires all data members of T to be trivially copyable "
+                    "(and not pointers or arrays)");
+
+      const std::byte* data_ = nullptr;
+      size_t file_size_ = 0;
+      size_t size_ = 0;
+      std::array<size_t, N> offsets_ = {};
+
+    public:
+      using value_type = T;
+
+      columnar_file() = default;
+
+      // Maps the file at path. is_open() is false if the file cannot be mapped or if its header
+      // does not match T (class name, data member names, types, and sizes) or the file size.
+      explicit
+      columnar_file(const char* path)
+      {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+          return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 and st.st_size > 0)
+          {
+            void* map = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (map != MAP_FAILED)
+              {
+                data_ = static_cast<const std::byte*>(map);
+                file_size_ = size_t(st.st_size);
+              }
+          }
+        ::close(fd);
+        std::uint64_t count = 0;
+        if (data_ != nullptr
+              and detail::columnar_check<T>({data_, file_size_}, count, offsets_))
+          size_ = count;
+        else
+          close();
+      }
+
+      columnar_file(const columnar_file&) = delete;
+
+      columnar_file&
+      operator=(const columnar_file&) = delete;
+
+      columnar_file(columnar_file&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)), file_size_(std::exchange(other.file_size_, 0)),
+        size_(std::exchange(other.size_, 0)), offsets_(other.offsets_)
+      {}
+
+      columnar_file&
+      operator=(columnar_file&& other) noexcept
+      {
+        std::swap(data_, other.data_);
+        std::swap(file_size_, other.file_size_);
+        std::swap(size_, other.size_);
+        std::swap(offsets_, other.offsets_);
+        return *this;
+      }
+
+      ~columnar_file()
+      { close(); }
+
+      void
+      close()
+      {
+        if (data_ != nullptr)
+          ::munmap(const_cast<std::byte*>(data_), file_size_);
+        data_ = nullptr;
+        file_size_ = 0;
+        size_ = 0;
+      }
+
+      bool
+      is_open() const
+      { return data_ != nullptr; }
+
+      // The number of records.
+      size_t
+      size() const
+      { return size_; }
+
+      bool
+      empty() const
+      { return size_ == 0; }
+
+      // The values of the data member given by index or name, e.g. column<"x">().
+      template <detail::data_member_id Id>
+        std::span<const data_member_type<T, detail::member_index<T, Id>>>
+        column() const
+        {
+          constexpr size_t Idx = detail::member_index<T, Id>;
+          return {reinterpret_cast<const data_member_type<T, Idx>*>(data_ + offsets_[Idx]),
+                  size_};
+        }
+
+      // Returns a copy of record i.
+      T
+      operator[](size_t i) const
+      {
+        T obj {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(obj) = column<Is>()[i]), ...);
+        }(std::make_index_sequence<N>());
+        return obj;
+      }
+    };
+#endif  // VIR_HAVE_COLUMNAR_FILE
+}
+
+#endif  // VIR_COLUMNAR_FILE_H_
@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_COMPARE_H_
+#define VIR_REFLECT_LIGHT_COMPARE_H_
+
+#include "reflect-light.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+
+// Equality and three-way comparison of reflectable types over all or a subset of their data
+// members.
+//
+// The data members are compared in the order given by the index array, stopping at the first
+// data member that differs. Reflectable data members (and ranges of them) are compared
+// member-wise, all other types via == and <=>.
+//
+// Consecutive data members (in index order and in memory) that are equal if and only if their
+// bytes are equal (see detail::bytewise) are compared with a single memcmp. If the bytes differ,
+// equal returns false; compare then compares the data members of the block one by one to
+// determine the order.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // The number of bytes to memcmp starting at data member Idxs[k]. Zero if the data member is
+    // not bytewise or if it is compared as part of a preceding block.
+    template <typename T, std::array Idxs>
+      constexpr auto compare_blocks = [] {
+        std::array<size_t, Idxs.size()> r = {};
+        constexpr std::array is_bytewise_member
+          = []<size_t... Is>(std::index_sequence<Is...>) {
+              return std::array<bool, sizeof...(Is)> {bytewise<data_member_type<T, Is>>...};
+            }(std::make_index_sequence<data_member_count<T>>());
+        if constexpr (checked_layout<T>().valid)
+          {
+            constexpr auto& l = layout<T>;
+            for (size_t k = 0, start = 0; k < Idxs.size(); ++k)
+              {
+                if (not is_bytewise_member[Idxs[k]])
+                  continue;
+                if (k != 0 and r[start] != 0 and Idxs[k] == Idxs[k - 1] + 1
+                      and l.offsets[Idxs[k]] == l.offsets[Idxs[start]] + r[start])
+                  r[start] += l.sizes[Idxs[k]];
+                else
+                  r[start = k] = l.sizes[Idxs[k]];
+              }
+          }
+        else
+          {
+            for (size_t k = 0; k < Idxs.size(); ++k)
+              if (is_bytewise_member[Idxs[k]])
+                r[k] = [&]<size_t... Is>(std::index_sequence<Is...>) {
+                  size_t size = 0;
+                  ((size = Is == Idxs[k] ? sizeof(data_member_type<T, Is>) : size), ...);
+                  return size;
+                }(std::make_index_sequence<data_member_count<T>>());
+          }
+        return r;
+      }();
+
+    // T is compared member-wise: T is reflectable or a range of such types. (The comparison
+    // operators of e.g. std::vector are not constrained on the element type.)
+    template <typename T>
+      constexpr bool compare_memberwise = [] {
+        if constexpr (reflectable<T>)
+          return true;
+        else if constexpr (std::ranges::input_range<const T>)
+          return compare_memberwise<std::ranges::range_value_t<const T>>;
+        else
+          return false;
+      }();
+
+    // The comparison category of member_compare<T> and compare_members<Idxs, T>, returned as a
+    // null pointer to the category (the categories are not default constructible).
+    template <typename T>
+      consteval auto*
+      member_compare_category();
+
+    template <typename T, std::array Idxs>
+      consteval auto*
+      compare_category()
+      {
+        return []<size_t... Ks>(std::index_sequence<Ks...>) {
+          return static_cast<std::common_comparison_category_t<std::remove_pointer_t<
+                   decltype(member_compare_category<data_member_type<T, Idxs[Ks]>>())>...>*>(
+                   nullptr);
+        }(std::make_index_sequence<Idxs.size()>());
+      }
+
+    template <typename T>
+      consteval auto*
+      member_compare_category()
+      {
+        if constexpr (reflectable<T>)
+          return compare_category<T, iota_array<data_member_count<T>>>();
+        else if constexpr (compare_memberwise<T>)
+          return member_compare_category<std::ranges::range_value_t<const T>>();
+        else
+          return static_cast<std::compare_three_way_result_t<T>*>(nullptr);
+      }
+
+    template <typename T, std::array Idxs>
+      using compare_result = std::remove_pointer_t<decltype(compare_category<T, Idxs>())>;
+
+    template <typename T>
+      constexpr bool
+      member_equal(const T& a, const T& b);
+
+    template <typename T>
+      constexpr std::remove_pointer_t<decltype(member_compare_category<T>())>
+      member_compare(const T& a, const T& b);
+
+    template <std::array Idxs, typename T>
+      constexpr bool
+      equal_members(const T& a, const T& b)
+      {
+        return [&]<size_t... Ks>(std::index_sequence<Ks...>) {
+          return ([&] {
+            constexpr size_t idx = Idxs[Ks];
+            constexpr size_t block = compare_blocks<T, Idxs>[Ks];
+            if constexpr (block != 0)
+              {
+                if (not std::is_constant_evaluated())
+                  return std::memcmp(std::addressof(data_member<idx>(a)),
+                                     std::addressof(data_member<idx>(b)), block) == 0;
+              }
+            else if constexpr (bytewise<data_member_type<T, idx>>)
+              {
+                // part of the preceding block
+                if (not std::is_constant_evaluated())
+                  return true;
+              }
+            return member_equal(data_member<idx>(a), data_member<idx>(b));
+          }() and ...);
+        }(std::make_index_sequence<Idxs.size()>());
+      }
+
+    template <std::array Idxs, typename T>
+      constexpr compare_result<T, Idxs>
+      compare_members(const T& a, const T& b)
+      {
+        compare_result<T, Idxs> result = std::strong_ordering::equal;
+        // whether the bytes of the current block are equal
+        bool block_equal = false;
+        [&]<size_t... Ks>(std::index_sequence<Ks...>) {
+          ([&] {
+            constexpr size_t idx = Idxs[Ks];
+            constexpr size_t block = compare_blocks<T, Idxs>[Ks];
+            if constexpr (block != 0)
+              {
+                block_equal = not std::is_constant_evaluated()
+                                and std::memcmp(std::addressof(data_member<idx>(a)),
+                                                std::addressof(data_member<idx>(b)), block) == 0;
+                if (block_equal)
+                  return true;
+              }
+            else if constexpr (bytewise<data_member_type<T, idx>>)
+              {
+                if (block_equal)
+                  return true;
+              }
+            result = member_compare(data_member<idx>(a), data_member<idx>(b));
+            return result == 0;
+          }() and ...);
+        }(std::make_index_sequence<Idxs.size()>());
+        return result;
+      }
+
+    template <typename T>
+      constexpr bool
+      member_equal(const T& a, const T& b)
+      {
+        if constexpr (reflectable<T>)
+          return equal_members<iota_array<data_member_count<T>>>(a, b);
+        else if constexpr (compare_memberwise<T>)
+          return std::ranges::equal(a, b, [](const auto& x, const auto& y) {
+                   return member_equal(x, y);
+                 });
+        else
+          return a == b;
+      }
+
+    template <typename T>
+      constexpr std::remove_pointer_t<decltype(member_compare_category<T>())>
+      member_compare(const T& a, const T& b)
+      {
+        if constexpr (reflectable<T>)
+          return compare_members<iota_array<data_member_count<T>>>(a, b);
+        else if constexpr (compare_memberwise<T>)
+          return std::lexicographical_compare_three_way(
+                   std::ranges::begin(a), std::ranges::end(a), std::ranges::begin(b),
+                   std::ranges::end(b), [](const auto& x, const auto& y) {
+                     return member_compare(x, y);
+                   });
+        else
+          return a <=> b;
+      }
+  }
+
+  // Whether the data members of a and b at the indexes Idxs are equal (in index array order,
+  // stopping at the first difference), e.g. equal_by<find_data_members<T, Pred>>(a, b).
+  template <std::array Idxs, reflectable T>
+    constexpr bool
+    equal_by(const T& a, const T& b)
+    { return detail::equal_members<Idxs>(a, b); }
+
+  // The three-way comparison of the data members of a and b at the indexes Idxs, in index array
+  // order (lexicographic). The result type is the common comparison category of the data members.
+  template <std::array Idxs, reflectable T>
+    constexpr auto
+    compare_by(const T& a, const T& b)
+    { return detail::compare_members<Idxs>(a, b); }
+
+  // equal_by / compare_by over all data members (including those of base classes)
+  template <reflectable T>
+    constexpr bool
+    equal(const T& a, const T& b)
+    { return equal_by<detail::iota_array<data_member_count<T>>>(a, b); }
+
+  template <reflectable T>
+    constexpr auto
+    compare(const T& a, const T& b)
+    { return compare_by<detail::iota_array<data_member_count<T>>>(a, b); }
+}
+
+#endif  // VIR_REFLECT_LIGHT_COMPARE_H_
@@ -0,0 +1,263 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_DELTA_H_
+#define VIR_REFLECT_LIGHT_DELTA_H_
+
+#include "reflect-light-serialize.h"
+
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <cstdint>
+#include <new>
+#include <ranges>
+#include <span>
+
+// Member-wise differences and delta encoding of reflectable types.
+//
+// diff(a, b) returns the set of data members (including those of base classes) that differ. A
+// delta stores the set as a header of (data_member_count<T> + 7) / 8 bytes (bit i % 8 of byte
+// i / 8 is data member i), followed by the serialize encoding of the data members in the set, in
+// index order. Decoding a delta overwrites only those data members, i.e. applying the deltas of
+// consecutive states in order to a copy of the first state reproduces the last state.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // Equality as seen by a receiver of the delta: float and double compare their bits, thus a
+    // change from 0. to -0. is a change while an unchanged NaN is not.
+    template <typename T>
+      constexpr bool
+      delta_equal(const T& a, const T& b)
+      {
+        if constexpr (std::is_same_v<T, float>)
+          return std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b);
+        else if constexpr (std::is_same_v<T, double>)
+          return std::bit_cast<std::uint64_t>(a) == std::bit_cast<std::uint64_t>(b);
+        else if constexpr (reflectable<T>)
+          return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return (delta_equal(data_member<Is>(a), data_member<Is>(b)) and ...);
+          }(std::make_index_sequence<data_member_count<T>>());
+        else if constexpr (std::ranges::input_range<const T>)
+          return std::ranges::equal(a, b, [](const auto& x, const auto& y) {
+                   return delta_equal(x, y);
+                 });
+        else
+          return a == b;
+      }
+
+    // Data member Idx of obj (T may be const). If the data member offsets are known, the data
+    // member is accessed via its offset: data_member<Idx> is not inlined for types with many
+    // data members. Otherwise (e.g. the position of a base class subobject is not known, see
+    // checked_layout) it falls back to data_member<Idx>.
+    template <size_t Idx, typename T>
+      constexpr auto&
+      delta_member(T& obj)
+      {
+        using C = std::remove_const_t<T>;
+        if constexpr (checked_layout<C>().valid)
+          if (not std::is_constant_evaluated())
+            {
+              using M = std::conditional_t<std::is_const_v<T>, const data_member_type<C, Idx>,
+                                           data_member_type<C, Idx>>;
+              using B = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+              return *std::launder(reinterpret_cast<M*>(reinterpret_cast<B*>(std::addressof(obj))
+                                                          + layout<C>.offsets[Idx]));
+            }
+        return data_member<Idx>(obj);
+      }
+
+    // Calls fun(ic<idx>, delta_member<idx>(obj)), which returns bool.
+    template <typename T, typename Fun>
+      constexpr auto delta_jump_table = []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<bool (*)(T&, Fun&), sizeof...(Is)> {
+          [](T& obj, Fun& fun) -> bool { return fun(ic<Is>, delta_member<Is>(obj)); }...
+        };
+      }(std::make_index_sequence<data_member_count<std::remove_const_t<T>>>());
+
+    // The set of data members as 64-bit words (bit i % 64 of word i / 64 is data member i).
+    template <typename T>
+      using delta_mask = std::array<std::uint64_t, (data_member_count<T> + 63) / 64>;
+
+    template <typename T>
+      constexpr size_t delta_header_size = (data_member_count<T> + 7) / 8;
+
+    template <typename T>
+      constexpr delta_mask<T>
+      diff_mask(const T& a, const T& b)
+      {
+        delta_mask<T> mask = {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((mask[Is / 64] |= std::uint64_t(not delta_equal(delta_member<Is>(a),
+                                                            delta_member<Is>(b))) << (Is % 64)),
+           ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return mask;
+      }
+
+    // Calls f(i) for every set bit i of mask, in increasing order. Stops and returns false if f
+    // returns false.
+    template <size_t W>
+      constexpr bool
+      for_each_set_bit(const std::array<std::uint64_t, W>& mask, auto&& f)
+      {
+        for (size_t w = 0; w < W; ++w)
+          for (std::uint64_t bits = mask[w]; bits != 0; bits &= bits - 1)
+            if (not f(w * 64 + size_t(std::countr_zero(bits))))
+              return false;
+        return true;
+      }
+
+    template <typename T>
+      constexpr bool
+      serialize_delta_members(auto& out, const T& obj, const delta_mask<T>& mask)
+      {
+        std::array<std::uint8_t, delta_header_size<T>> header = {};
+        for (size_t i = 0; i < header.size(); ++i)
+          header[i] = std::uint8_t(mask[i / 8] >> (8 * (i % 8)));
+        if (not out.raw(header.data(), header.size()))
+          return false;
+        if constexpr (data_member_count<T> == 0)
+          return true;
+        else
+          {
+            auto fun = [&](auto, const auto& x) { return serialize_value(out, x); };
+            return for_each_set_bit(mask, [&](size_t idx) {
+                     return delta_jump_table<const T, decltype(fun)>[idx](obj, fun);
+                   });
+          }
+      }
+
+    // Reads the header of a delta and then the data members it contains into obj. Returns false
+    // if in ends prematurely or if the header contains data members that T does not have.
+    template <typename T>
+      constexpr bool
+      deserialize_delta_members(serial_reader& in, T& obj, delta_mask<T>& mask)
+      {
+        std::array<std::uint8_t, delta_header_size<T>> header = {};
+        if (not in.raw(header.data(), header.size()))
+          return false;
+        mask = {};
+        for (size_t i = 0; i < header.size(); ++i)
+          mask[i / 8] |= std::uint64_t(header[i]) << (8 * (i % 8));
+        if constexpr (data_member_count<T> == 0)
+          return true;
+        else
+          {
+            constexpr size_t tail = data_member_count<T> % 64;
+            if (tail != 0 and (mask.back() >> tail) != 0)
+              return false;
+            auto fun = [&](auto, auto& x) { return deserialize_value(in, x); };
+            return for_each_set_bit(mask, [&](size_t idx) {
+                     return delta_jump_table<T, decltype(fun)>[idx](obj, fun);
+                   });
+          }
+      }
+
+    template <typename T>
+      delta_mask<T>
+      to_delta_mask(const std::bitset<data_member_count<T>>& changed)
+      {
+        constexpr size_t N = data_member_count<T>;
+        delta_mask<T> mask = {};
+        if constexpr (N > 64)
+          {
+            const std::bitset<N> low(~std::uint64_t());
+            for (size_t w = 0; w < mask.size(); ++w)
+              mask[w] = ((changed >> (64 * w)) & low).to_ullong();
+          }
+        else if constexpr (N != 0)
+          mask[0] = changed.to_ullong();
+        return mask;
+      }
+
+    template <typename T>
+      std::bitset<data_member_count<T>>
+      to_bitset(const delta_mask<T>& mask)
+      {
+        std::bitset<data_member_count<T>> changed;
+        for (size_t w = mask.size(); w > 0; --w)
+          {
+            changed <<= 64;
+            changed |= std::bitset<data_member_count<T>>(mask[w - 1]);
+          }
+        return changed;
+      }
+  }
+
+  // The data members (including those of base classes) where a and b differ. Data members are
+  // compared member-wise (recursively) and float / double by their bits.
+  template <reflectable T>
+    std::bitset<data_member_count<T>>
+    diff(const T& a, const T& b)
+    { return detail::to_bitset<T>(detail::diff_mask(a, b)); }
+
+  // Returns the number of bytes serialize_delta(obj, changed, buffer) writes.
+  template <reflectable T>
+    size_t
+    serialized_delta_size(const T& obj, const std::bitset<data_member_count<T>>& changed)
+    {
+      detail::serial_counter counter;
+      detail::serialize_delta_members(counter, obj, detail::to_delta_mask<T>(changed));
+      return counter.size;
+    }
+
+  // Writes the delta consisting of the data members of obj in changed to the front of buffer and
+  // returns the number of bytes written. Returns 0 if buffer is too small; the contents of buffer
+  // are unspecified in that case.
+  template <reflectable T>
+    size_t
+    serialize_delta(const T& obj, const std::bitset<data_member_count<T>>& changed,
+                    std::span<std::byte> buffer)
+    {
+      detail::serial_writer out {buffer.data(), buffer.data() + buffer.size()};
+      if (not detail::serialize_delta_members(out, obj, detail::to_delta_mask<T>(changed)))
+        return 0;
+      return size_t(out.ptr - buffer.data());
+    }
+
+  // Writes the delta from prev to obj, i.e. serialize_delta(obj, diff(prev, obj), buffer).
+  template <reflectable T>
+    size_t
+    serialize_delta(const T& prev, const T& obj, std::span<std::byte> buffer)
+    {
+      detail::serial_writer out {buffer.data(), buffer.data() + buffer.size()};
+      if (not detail::serialize_delta_members(out, obj, detail::diff_mask(prev, obj)))
+        return 0;
+      return size_t(out.ptr - buffer.data());
+    }
+
+  // Reads a delta from the front of buffer into the data members of obj that it contains and
+  // returns the number of bytes consumed. Returns 0 if buffer ends prematurely or if the header
+  // is invalid; obj is partially overwritten in that case.
+  template <reflectable T>
+    size_t
+    deserialize_delta(T& obj, std::span<const std::byte> buffer)
+    {
+      detail::serial_reader in {buffer.data(), buffer.data() + buffer.size()};
+      detail::delta_mask<T> mask;
+      if (not detail::deserialize_delta_members(in, obj, mask))
+        return 0;
+      return size_t(in.ptr - buffer.data());
+    }
+
+  // As above, and stores the set of data members that were read in changed.
+  template <reflectable T>
+    size_t
+    deserialize_delta(T& obj, std::span<const std::byte> buffer,
+                      std::bitset<data_member_count<T>>& changed)
+    {
+      detail::serial_reader in {buffer.data(), buffer.data() + buffer.size()};
+      detail::delta_mask<T> mask;
+      if (not detail::deserialize_delta_members(in, obj, mask))
+        return 0;
+      changed = detail::to_bitset<T>(mask);
+      return size_t(in.ptr - buffer.data());
+    }
+}
+
+#endif  // VIR_REFLECT_LIGHT_DELTA_H_
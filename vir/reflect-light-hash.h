@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_HASH_H_
+#define VIR_REFLECT_LIGHT_HASH_H_
+
+#include "reflect-light.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ranges>
+#include <vector>
+
+// Hashing of reflectable types.
+//
+// hash(obj) combines the hashes of all data members (including those of base classes) in data
+// member index order (one multiplication per data member) and finishes with a strong 64-bit mixer.
+// The data members are hashed as follows:
+// - integers, enums, and pointers: their value
+// - float and double: their value, where 0. and -0. hash equal
+// - reflectable types: recursively
+// - ranges (e.g. std::string, std::vector, std::array): the number of elements and all elements;
+//   contiguous ranges of types with unique object representation in one pass over their bytes
+// - all other types: std::hash
+//
+// If an object's value is fully determined by its object representation (unique object
+// representation, and the data members cover all bytes of the object) it is hashed in one pass
+// over its bytes instead of member-wise.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // Strong 64-bit mixer (every input bit affects every output bit).
+    constexpr std::uint64_t
+    hash_mix(std::uint64_t x)
+    {
+      x ^= x >> 32;
+      x *= 0xd6e8feb86659fd93u;
+      x ^= x >> 32;
+      x *= 0xd6e8feb86659fd93u;
+      x ^= x >> 32;
+      return x;
+    }
+
+    // Adds value to the hash state. The result is a bijection of value for a given hash; the
+    // rotation moves the well-mixed high bits of the product to the low bits for the next step.
+    constexpr std::uint64_t
+    hash_combine(std::uint64_t hash, std::uint64_t value)
+    { return std::rotl((hash ^ value) * 0x9e3779b97f4a7c15u, 29); }
+
+    // Little-endian load of n <= 8 bytes
+    constexpr std::uint64_t
+    load_bytes(const unsigned char* ptr, size_t n)
+    {
+      if constexpr (std::endian::native == std::endian::little)
+        if (not std::is_constant_evaluated())
+          {
+            if (n == 8)
+              {
+                std::uint64_t word;
+                std::memcpy(&word, ptr, 8);
+                return word;
+              }
+            else if (n >= 4)
+              {
+                // two overlapping loads
+                std::uint32_t lo, hi;
+                std::memcpy(&lo, ptr, 4);
+                std::memcpy(&hi, ptr + n - 4, 4);
+                return lo | (std::uint64_t(hi) << (8 * (n - 4)));
+              }
+          }
+      std::uint64_t word = 0;
+      for (size_t i = 0; i < n; ++i)
+        word |= std::uint64_t(ptr[i]) << (8 * i);
+      return word;
+    }
+
+    // Hashes n bytes in four independent lanes of 8 bytes each (no dependency between the lanes,
+    // i.e. they execute in parallel / can be vectorized), followed by the remaining words.
+    constexpr std::uint64_t
+    hash_bytes(const unsigned char* ptr, size_t n)
+    {
+      constexpr std::uint64_t p1 = 0x9e3779b185ebca87u;
+      constexpr std::uint64_t p2 = 0xc2b2ae3d27d4eb4fu;
+      std::uint64_t hash = n * p1;
+      size_t i = 0;
+      if (n >= 32)
+        {
+          constexpr auto round = [](std::uint64_t lane, std::uint64_t word) {
+            return std::rotl(lane + word * p2, 31) * p1;
+          };
+          std::uint64_t l0 = p1 + p2, l1 = p2, l2 = 0, l3 = -p1;
+          for (; i + 32 <= n; i += 32)
+            {
+              l0 = round(l0, load_bytes(ptr + i, 8));
+              l1 = round(l1, load_bytes(ptr + i + 8, 8));
+              l2 = round(l2, load_bytes(ptr + i + 16, 8));
+              l3 = round(l3, load_bytes(ptr + i + 24, 8));
+            }
+          hash ^= std::rotl(l0, 1) + std::rotl(l1, 7) + std::rotl(l2, 12) + std::rotl(l3, 18);
+        }
+      for (; i + 8 <= n; i += 8)
+        hash = std::rotl(hash ^ load_bytes(ptr + i, 8) * p2, 27) * p1;
+      if (i < n)
+        {
+          // the remaining bytes: shift out the already hashed part of the last 8 bytes
+          const std::uint64_t tail = n < 8 ? load_bytes(ptr, n)
+                                           : load_bytes(ptr + n - 8, 8) >> (8 * (i + 8 - n));
+          hash = std::rotl(hash ^ tail * p2, 27) * p1;
+        }
+      return hash_mix(hash);
+    }
+
+    // Hashes the object representation of n objects of type T.
+    template <typename T>
+      constexpr std::uint64_t
+      hash_raw_objects(const T* ptr, size_t n)
+      {
+        if (std::is_constant_evaluated())
+          {
+            std::vector<unsigned char> bytes(n * sizeof(T));
+            for (size_t i = 0; i < n; ++i)
+              {
+                const auto obj = std::bit_cast<std::array<unsigned char, sizeof(T)>>(ptr[i]);
+                for (size_t j = 0; j < sizeof(T); ++j)
+                  bytes[i * sizeof(T) + j] = obj[j];
+              }
+            return hash_bytes(bytes.data(), bytes.size());
+          }
+        else
+          return hash_bytes(reinterpret_cast<const unsigned char*>(ptr), n * sizeof(T));
+      }
+
+    template <typename T>
+      constexpr std::uint64_t
+      hash_value(const T& x);
+
+    template <typename R>
+      constexpr std::uint64_t
+      hash_range(const R& r)
+      {
+        using V = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> and std::ranges::sized_range<R>
+                        and bytewise<V> and std::is_same_v<std::ranges::range_reference_t<const R>,
+                                                           const V&>)
+          return hash_combine(std::ranges::size(r),
+                              hash_raw_objects(std::ranges::data(r), std::ranges::size(r)));
+        else
+          {
+            std::uint64_t hash = 0;
+            size_t n = 0;
+            for (const auto& x : r)
+              {
+                hash = hash_combine(hash, hash_value(x));
+                ++n;
+              }
+            return hash_mix(hash_combine(hash, n));
+          }
+      }
+
+    template <typename T>
+      constexpr std::uint64_t
+      hash_value(const T& x)
+      {
+        // scalars are not mixed here, hash_combine and the final hash_mix of the enclosing
+        // object / range do that
+        if constexpr (std::is_integral_v<T> or std::is_enum_v<T>)
+          return static_cast<std::uint64_t>(x);
+        else if constexpr (std::is_pointer_v<T>)
+          return reinterpret_cast<std::uintptr_t>(x);
+        else if constexpr (std::is_same_v<T, float>)
+          return x == 0 ? 0 : std::bit_cast<std::uint32_t>(x);
+        else if constexpr (std::is_same_v<T, double>)
+          return x == 0 ? 0 : std::bit_cast<std::uint64_t>(x);
+        else if constexpr (bytewise<T>)
+          return hash_raw_objects(std::addressof(x), 1);
+        else if constexpr (reflectable<T>)
+          return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            std::uint64_t hash = 0;
+            ((hash = hash_combine(hash, hash_value(data_member<Is>(x)))), ...);
+            return hash_mix(hash);
+          }(std::make_index_sequence<data_member_count<T>>());
+        else if constexpr (std::ranges::input_range<const T>)
+          return hash_range(x);
+        else
+          {
+            static_assert(std::is_invocable_r_v<size_t, std::hash<T>, const T&>,
+                          "vir::refl::hash: data member type is neither reflectable, a range, "
+                          "nor hashable via std::hash");
+            return std::hash<T>()(x);
+          }
+      }
+  }
+
+  // A 64-bit hash of all data members of obj (including those of base classes).
+  template <reflectable T>
+    constexpr std::uint64_t
+    hash(const T& obj)
+    { return detail::hash_value(obj); }
+
+  // Hash function object for unordered containers, e.g.
+  // std::unordered_map<Key, Value, vir::refl::hasher>.
+  struct hasher
+  {
+    template <reflectable T>
+      constexpr size_t
+      operator()(const T& obj) const
+      { return static_cast<size_t>(hash(obj)); }
+  };
+}
+
+// std::hash for reflectable types calls vir::refl::hash, e.g. for std::unordered_set<Key>. A
+// full specialization of std::hash for a reflectable type takes precedence.
+template <vir::refl::reflectable T>
+  requires std::same_as<T, std::remove_cv_t<T>>
+  struct std::hash<T>
+  {
+    constexpr size_t
+    operator()(const T& obj) const
+    { return static_cast<size_t>(vir::refl::hash(obj)); }
+  };
+
+#endif  // VIR_REFLECT_LIGHT_HASH_H_
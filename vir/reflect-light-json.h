@@ -0,0 +1,650 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_JSON_H_
+#define VIR_REFLECT_LIGHT_JSON_H_
+
+#include "reflect-light.h"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+
+// JSON input and output of reflectable types.
+//
+// Every reflectable object is written as a JSON object with one key per data member (including
+// those of base classes). The text in front of each value ('{"name":' for the first data member,
+// ',"name":' for all others) is a compile-time constant; at run time only the values are
+// formatted.
+//
+// from_json parses directly into the data members, without building a document tree. Object keys
+// are dispatched via visit_data_member, i.e. a perfect hash over the data member names.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // The text in front of the value of data member Idx.
+    template <typename T, size_t Idx>
+      constexpr auto json_key = [] {
+        if constexpr (Idx == 0)
+          return vir::constexpr_string<"{\"">() + data_member_name<T, Idx>
+                   + vir::constexpr_string<"\":">();
+        else
+          return vir::constexpr_string<",\"">() + data_member_name<T, Idx>
+                   + vir::constexpr_string<"\":">();
+      }();
+
+    struct json_writer
+    {
+      char* ptr;
+      char* const end;
+
+      bool
+      put(std::string_view str)
+      {
+        if (size_t(end - ptr) < str.size())
+          return false;
+        std::memcpy(ptr, str.data(), str.size());
+        ptr += str.size();
+        return true;
+      }
+
+      bool
+      put(char c)
+      {
+        if (ptr == end)
+          return false;
+        *ptr++ = c;
+        return true;
+      }
+    };
+
+    inline bool
+    json_string(json_writer& out, std::string_view str)
+    {
+      if (not out.put('"'))
+        return false;
+      size_t done = 0;
+      for (size_t i = 0; i < str.size(); ++i)
+        {
+          const unsigned char c = str[i];
+          if (c >= 0x20 and c != '"' and c != '\\')
+            continue;
+          if (not out.put(str.substr(done, i - done)))
+            return false;
+          done = i + 1;
+          bool ok = true;
+          switch (c)
+            {
+            case '"':
+              ok = out.put("\\\"");
+              break;
+            case '\\':
+              ok = out.put("\\\\");
+              break;
+            case '\n':
+              ok = out.put("\\n");
+              break;
+            case '\t':
+              ok = out.put("\\t");
+              break;
+            case '\r':
+              ok = out.put("\\r");
+              break;
+            case '\b':
+              ok = out.put("\\b");
+              break;
+            case '\f':
+              ok = out.put("\\f");
+              break;
+            default:
+              {
+                const char escaped[6] = {'\\', 'u', '0', '0', "0123456789abcdef"[c >> 4],
+                                         "0123456789abcdef"[c & 0xf]};
+                ok = out.put(std::string_view(escaped, 6));
+              }
+            }
+          if (not ok)
+            return false;
+        }
+      return out.put(str.substr(done)) and out.put('"');
+    }
+
+    template <typename T>
+      bool
+      json_value(json_writer& out, const T& x);
+
+    template <typename T>
+      bool
+      json_object(json_writer& out, const T& obj)
+      {
+        if constexpr (data_member_count<T> == 0)
+          return out.put("{}");
+        else
+          return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return ((out.put(json_key<T, Is>.view()) and json_value(out, data_member<Is>(obj)))
+                      and ...) and out.put('}');
+          }(std::make_index_sequence<data_member_count<T>>());
+      }
+
+    template <typename T>
+      bool
+      json_value(json_writer& out, const T& x)
+      {
+        if constexpr (std::is_same_v<T, bool>)
+          return out.put(x ? std::string_view("true") : std::string_view("false"));
+        else if constexpr (std::is_same_v<T, char>)
+          return json_string(out, std::string_view(&x, 1));
+        else if constexpr (std::is_floating_point_v<T>)
+          {
+            // JSON has no representation of infinity and NaN
+            if (not std::isfinite(x))
+              return out.put("null");
+            const auto [end, ec] = std::to_chars(out.ptr, out.end, x);
+            out.ptr = end;
+            return ec == std::errc();
+          }
+        else if constexpr (requires(char* p) { std::to_chars(p, p, x); })
+          {
+            const auto [end, ec] = std::to_chars(out.ptr, out.end, x);
+            out.ptr = end;
+            return ec == std::errc();
+          }
+        else if constexpr (std::is_enum_v<T>)
+          return json_value(out, static_cast<std::underlying_type_t<T>>(x));
+        else if constexpr (reflectable<T>)
+          return json_object(out, x);
+        else if constexpr (not std::is_array_v<T>
+                             and std::is_convertible_v<const T&, std::string_view>)
+          return json_string(out, x);
+        else if constexpr (requires { std::begin(x); std::end(x); })
+          {
+            if (not out.put('['))
+              return false;
+            bool first = true;
+            for (const auto& element : x)
+              {
+                if (not first and not out.put(','))
+                  return false;
+                if (not json_value(out, element))
+                  return false;
+                first = false;
+              }
+            return out.put(']');
+          }
+        else
+          static_assert(reflectable<T>, "vir::refl::to_json: unsupported data member type");
+      }
+  }
+
+  // Writes obj as JSON to the front of buffer and returns the number of characters written (no
+  // terminating null character). Returns 0 if buffer is too small; the contents of buffer are
+  // unspecified in that case.
+  template <reflectable T>
+    size_t
+    to_json(const T& obj, std::span<char> buffer)
+    {
+      detail::json_writer out {buffer.data(), buffer.data() + buffer.size()};
+      if (not detail::json_object(out, obj))
+        return 0;
+      return size_t(out.ptr - buffer.data());
+    }
+
+  // Replaces the contents of str with obj as JSON. The capacity of str is reused, i.e. once str
+  // has grown large enough, no allocations happen.
+  template <reflectable T>
+    void
+    to_json(const T& obj, std::string& str)
+    {
+      str.resize(str.capacity());
+      size_t n;
+      while ((n = to_json(obj, std::span<char>(str))) == 0)
+        str.resize(str.size() < 64 ? 64 : 2 * str.size());
+      str.resize(n);
+    }
+
+  namespace detail
+  {
+    struct json_reader
+    {
+      const char* ptr;
+      const char* const end;
+
+      void
+      skip_whitespace()
+      {
+        while (ptr != end and (*ptr == ' ' or *ptr == '\n' or *ptr == '\r' or *ptr == '\t'))
+          ++ptr;
+      }
+
+      // Skips whitespace and consumes c if it is the next character.
+      bool
+      consume(char c)
+      {
+        skip_whitespace();
+        if (ptr == end or *ptr != c)
+          return false;
+        ++ptr;
+        return true;
+      }
+
+      bool
+      consume(std::string_view word)
+      {
+        if (size_t(end - ptr) < word.size() or std::string_view(ptr, word.size()) != word)
+          return false;
+        ptr += word.size();
+        return true;
+      }
+
+      // Consumes a JSON number and returns its text (empty if there is none).
+      std::string_view
+      number(bool& integral)
+      {
+        const char* const first = ptr;
+        const auto digits = [&] {
+          const char* const d = ptr;
+          while (ptr != end and *ptr >= '0' and *ptr <= '9')
+            ++ptr;
+          return ptr != d;
+        };
+        if (ptr != end and *ptr == '-')
+          ++ptr;
+        if (ptr != end and *ptr == '0')
+          ++ptr; // no leading zeros
+        else if (not digits())
+          return {};
+        integral = true;
+        if (ptr != end and *ptr == '.')
+          {
+            ++ptr;
+            integral = false;
+            if (not digits())
+              return {};
+          }
+        if (ptr != end and (*ptr == 'e' or *ptr == 'E'))
+          {
+            ++ptr;
+            integral = false;
+            if (ptr != end and (*ptr == '+' or *ptr == '-'))
+              ++ptr;
+            if (not digits())
+              return {};
+          }
+        return {first, size_t(ptr - first)};
+      }
+    };
+
+    inline int
+    json_hex_digit(char c)
+    {
+      if (c >= '0' and c <= '9')
+        return c - '0';
+      if (c >= 'a' and c <= 'f')
+        return c - 'a' + 10;
+      if (c >= 'A' and c <= 'F')
+        return c - 'A' + 10;
+      return -1;
+    }
+
+    inline bool
+    json_hex4(json_reader& in, unsigned& value)
+    {
+      if (in.end - in.ptr < 4)
+        return false;
+      value = 0;
+      for (int i = 0; i < 4; ++i)
+        {
+          const int d = json_hex_digit(*in.ptr++);
+          if (d < 0)
+            return false;
+          value = value * 16 + unsigned(d);
+        }
+      return true;
+    }
+
+    // Parses the rest of a JSON string (after the opening quote) and passes the unescaped
+    // contents in pieces to append.
+    bool
+    json_string_pieces(json_reader& in, auto&& append)
+    {
+      const char* done = in.ptr;
+      while (in.ptr != in.end)
+        {
+          const unsigned char c = *in.ptr;
+          if (c == '"')
+            {
+              append(std::string_view(done, size_t(in.ptr - done)));
+              ++in.ptr;
+              return true;
+            }
+          if (c < 0x20)
+            return false;
+          if (c != '\\')
+            {
+              ++in.ptr;
+              continue;
+            }
+          append(std::string_view(done, size_t(in.ptr - done)));
+          if (++in.ptr == in.end)
+            return false;
+          const char e = *in.ptr++;
+          switch (e)
+            {
+            case '"':
+            case '\\':
+            case '/':
+              append(std::string_view(&e, 1));
+              break;
+            case 'n':
+              append("\n");
+              break;
+            case 't':
+              append("\t");
+              break;
+            case 'r':
+              append("\r");
+              break;
+            case 'b':
+              append("\b");
+              break;
+            case 'f':
+              append("\f");
+              break;
+            case 'u':
+              {
+                unsigned cp;
+                if (not json_hex4(in, cp))
+                  return false;
+                if (cp >= 0xd800 and cp < 0xdc00)
+                  {
+                    unsigned low;
+                    if (not in.consume("\\u") or not json_hex4(in, low) or low < 0xdc00
+                          or low >= 0xe000)
+                      return false;
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                  }
+                else if (cp >= 0xdc00 and cp < 0xe000)
+                  return false;
+                // UTF-8 encoding
+                char utf8[4];
+                int n = 0;
+                if (cp < 0x80)
+                  utf8[n++] = char(cp);
+                else if (cp < 0x800)
+                  {
+                    utf8[n++] = char(0xc0 | (cp >> 6));
+                    utf8[n++] = char(0x80 | (cp & 0x3f));
+                  }
+                else if (cp < 0x10000)
+                  {
+                    utf8[n++] = char(0xe0 | (cp >> 12));
+                    utf8[n++] = char(0x80 | ((cp >> 6) & 0x3f));
+                    utf8[n++] = char(0x80 | (cp & 0x3f));
+                  }
+                else
+                  {
+                    utf8[n++] = char(0xf0 | (cp >> 18));
+                    utf8[n++] = char(0x80 | ((cp >> 12) & 0x3f));
+                    utf8[n++] = char(0x80 | ((cp >> 6) & 0x3f));
+                    utf8[n++] = char(0x80 | (cp & 0x3f));
+                  }
+                append(std::string_view(utf8, size_t(n)));
+                break;
+              }
+            default:
+              return false;
+            }
+          done = in.ptr;
+        }
+      return false;
+    }
+
+    // Objects and arrays nested deeper than this are rejected, so that malicious input cannot
+    // overflow the stack.
+    inline constexpr int json_max_depth = 256;
+
+    // Skips any JSON value, with at most max_depth levels of nested objects and arrays.
+    inline bool
+    json_skip_value(json_reader& in, int max_depth = json_max_depth)
+    {
+      constexpr auto ignore = [](std::string_view) {};
+      in.skip_whitespace();
+      if (in.ptr == in.end)
+        return false;
+      switch (*in.ptr)
+        {
+        case '{':
+          ++in.ptr;
+          if (max_depth == 0)
+            return false;
+          if (in.consume('}'))
+            return true;
+          do
+            if (not in.consume('"') or not json_string_pieces(in, ignore) or not in.consume(':')
+                  or not json_skip_value(in, max_depth - 1))
+              return false;
+          while (in.consume(','));
+          return in.consume('}');
+        case '[':
+          ++in.ptr;
+          if (max_depth == 0)
+            return false;
+          if (in.consume(']'))
+            return true;
+          do
+            if (not json_skip_value(in, max_depth - 1))
+              return false;
+          while (in.consume(','));
+          return in.consume(']');
+        case '"':
+          ++in.ptr;
+          return json_string_pieces(in, ignore);
+        case 't':
+          return in.consume("true");
+        case 'f':
+          return in.consume("false");
+        case 'n':
+          return in.consume("null");
+        default:
+          {
+            bool integral;
+            return not in.number(integral).empty();
+          }
+        }
+    }
+
+    // Parses a value into x, with at most max_depth levels of nested objects and arrays (like
+    // json_skip_value).
+    template <typename T>
+      bool
+      json_parse(json_reader& in, T& x, int max_depth);
+
+    // The size of the longest data member name of T (at least 1).
+    template <typename T>
+      consteval size_t
+      json_max_name_size()
+      {
+        size_t n = 1;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((n = std::max(n, data_member_name<T, Is>.size())), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return n;
+      }
+
+    template <typename T>
+      bool
+      json_parse_object(json_reader& in, T& obj, int max_depth)
+      {
+        if (not in.consume('{') or max_depth == 0)
+          return false;
+        if (in.consume('}'))
+          return true;
+        do
+          {
+            if (not in.consume('"'))
+              return false;
+            // the common case: the key contains no escapes and can be looked up in place
+            const char* const key = in.ptr;
+            while (in.ptr != in.end and *in.ptr != '"' and *in.ptr != '\\'
+                     and static_cast<unsigned char>(*in.ptr) >= 0x20)
+              ++in.ptr;
+            std::string_view name(key, size_t(in.ptr - key));
+            char buffer[json_max_name_size<T>()];
+            if (in.ptr != in.end and *in.ptr == '"')
+              ++in.ptr;
+            else
+              {
+                // keys longer than the longest data member name cannot be data member names
+                size_t size = 0;
+                in.ptr = key;
+                if (not json_string_pieces(in, [&](std::string_view piece) {
+                      if (size + piece.size() <= sizeof(buffer))
+                        std::memcpy(buffer + size, piece.data(), piece.size());
+                      size += piece.size();
+                    }))
+                  return false;
+                name = size <= sizeof(buffer) ? std::string_view(buffer, size) : std::string_view();
+              }
+            if (not in.consume(':'))
+              return false;
+            bool ok = true;
+            if (name.empty()
+                  or not visit_data_member(obj, name, [&](auto& member) {
+                           ok = json_parse(in, member, max_depth - 1);
+                         }))
+              ok = json_skip_value(in, max_depth - 1);
+            if (not ok)
+              return false;
+          }
+        while (in.consume(','));
+        return in.consume('}');
+      }
+
+    template <typename T>
+      bool
+      json_parse_number(json_reader& in, T& x)
+      {
+        in.skip_whitespace();
+        bool integral = false;
+        const std::string_view num = in.number(integral);
+        if (num.empty() or (std::is_integral_v<T> and not integral))
+          return false;
+        const auto [end, ec] = std::from_chars(num.data(), num.data() + num.size(), x);
+        return ec == std::errc() and end == num.data() + num.size();
+      }
+
+    template <typename T>
+      bool
+      json_parse(json_reader& in, T& x, int max_depth)
+      {
+        if constexpr (std::is_same_v<T, bool>)
+          {
+            in.skip_whitespace();
+            if (in.consume("true"))
+              x = true;
+            else if (in.consume("false"))
+              x = false;
+            else
+              return false;
+            return true;
+          }
+        else if constexpr (std::is_same_v<T, char>)
+          {
+            size_t size = 0;
+            if (not in.consume('"') or not json_string_pieces(in, [&](std::string_view piece) {
+                  if (size == 0 and piece.size() == 1)
+                    x = piece[0];
+                  size += piece.size();
+                }))
+              return false;
+            return size == 1;
+          }
+        else if constexpr (std::is_floating_point_v<T>)
+          {
+            in.skip_whitespace();
+            // to_json writes infinity and NaN as null
+            if (in.consume("null"))
+              {
+                x = std::numeric_limits<T>::quiet_NaN();
+                return true;
+              }
+            return json_parse_number(in, x);
+          }
+        else if constexpr (requires(const char* p) { std::from_chars(p, p, x); })
+          return json_parse_number(in, x);
+        else if constexpr (std::is_enum_v<T>)
+          {
+            std::underlying_type_t<T> value;
+            if (not json_parse(in, value, max_depth))
+              return false;
+            x = static_cast<T>(value);
+            return true;
+          }
+        else if constexpr (reflectable<T>)
+          return json_parse_object(in, x, max_depth);
+        else if constexpr (requires { x.clear(); x.append(std::string_view()); })
+          {
+            x.clear();
+            return in.consume('"')
+                     and json_string_pieces(in, [&](std::string_view piece) { x.append(piece); });
+          }
+        else if constexpr (requires { x.clear(); x.emplace_back(); })
+          {
+            x.clear();
+            if (not in.consume('[') or max_depth == 0)
+              return false;
+            if (in.consume(']'))
+              return true;
+            do
+              if (not json_parse(in, x.emplace_back(), max_depth - 1))
+                return false;
+            while (in.consume(','));
+            return in.consume(']');
+          }
+        else if constexpr (requires { std::begin(x); std::end(x); })
+          {
+            // fixed size: the number of elements must match
+            if (not in.consume('[') or max_depth == 0)
+              return false;
+            bool first = true;
+            for (auto& element : x)
+              {
+                if (not first and not in.consume(','))
+                  return false;
+                if (not json_parse(in, element, max_depth - 1))
+                  return false;
+                first = false;
+              }
+            return in.consume(']');
+          }
+        else
+          static_assert(reflectable<T>, "vir::refl::from_json: unsupported data member type");
+      }
+  }
+
+  // Parses the JSON object in json into obj. Keys without matching data member are ignored and
+  // data members without matching key keep their value. Returns false if json is not a valid
+  // JSON object or a value does not fit the type of its data member; obj is partially assigned in
+  // that case.
+  template <reflectable T>
+    bool
+    from_json(std::string_view json, T& obj)
+    {
+      detail::json_reader in {json.data(), json.data() + json.size()};
+      if (not detail::json_parse_object(in, obj, detail::json_max_depth))
+        return false;
+      in.skip_whitespace();
+      return in.ptr == in.end;
+    }
+}
+
+#endif  // VIR_REFLECT_LIGHT_JSON_H_
@@ -0,0 +1,219 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_MACROS_H_
+#define VIR_REFLECT_LIGHT_MACROS_H_
+
+// Only the preprocessor macros of reflect-light.h. Users of the vir.reflect_light module include
+// this header (after or before 'import vir.reflect_light;') for VIR_MAKE_REFLECTABLE. The
+// expansion only refers to names the module exports.
+
+// Recursive macro implementation inspired by https://www.scs.stanford.edu/~dm/blog/va-opt.html
+//
+// VIR_REFLECT_LIGHT_FOR_EACH(op, a, b, ...) expands to "op(a), op(b), ...". Every recursion step
+// handles a chunk of 32 arguments. Lists of up to 32 arguments don't need the recursion and thus
+// skip the VIR_REFLECT_LIGHT_EXPAND rescans altogether. Longer lists are limited by the number of
+// recursion steps VIR_REFLECT_LIGHT_EXPAND allows (> 80) times 32.
+
+#define VIR_REFLECT_LIGHT_PARENS ()
+#define VIR_REFLECT_LIGHT_EXPAND(...) VIR_REFLECT_LIGHT_EXPAND3(VIR_REFLECT_LIGHT_EXPAND3(         \
+                                        VIR_REFLECT_LIGHT_EXPAND3(VIR_REFLECT_LIGHT_EXPAND3(       \
+                                          __VA_ARGS__))))
+#define VIR_REFLECT_LIGHT_EXPAND3(...) VIR_REFLECT_LIGHT_EXPAND2(VIR_REFLECT_LIGHT_EXPAND2(        \
+                                         VIR_REFLECT_LIGHT_EXPAND2(VIR_REFLECT_LIGHT_EXPAND2(      \
+                                           __VA_ARGS__))))
+#define VIR_REFLECT_LIGHT_EXPAND2(...) VIR_REFLECT_LIGHT_EXPAND1(VIR_REFLECT_LIGHT_EXPAND1(        \
+                                         VIR_REFLECT_LIGHT_EXPAND1(VIR_REFLECT_LIGHT_EXPAND1(      \
+                                           __VA_ARGS__))))
+#define VIR_REFLECT_LIGHT_EXPAND1(...) __VA_ARGS__
+
+// The 33rd argument is '0' (which cannot be a data member name) iff there are at most 32 arguments.
+#define VIR_REFLECT_LIGHT_ARG33(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15,  \
+                                _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28,   \
+                                _29, _30, _31, _32, x, ...) x
+#define VIR_REFLECT_LIGHT_SECOND(...) VIR_REFLECT_LIGHT_SECOND_(__VA_ARGS__)
+#define VIR_REFLECT_LIGHT_SECOND_(a, b, ...) b
+#define VIR_REFLECT_LIGHT_IS_SHORT_0 ~, VIR_REFLECT_LIGHT_FOR_EACH_SHORT
+#define VIR_REFLECT_LIGHT_SELECT(x) VIR_REFLECT_LIGHT_SELECT_(x)
+#define VIR_REFLECT_LIGHT_SELECT_(x)                                                               \
+  VIR_REFLECT_LIGHT_SECOND(VIR_REFLECT_LIGHT_IS_SHORT_##x, VIR_REFLECT_LIGHT_FOR_EACH_LONG)
+#define VIR_REFLECT_LIGHT_CALL(f, ...) f(__VA_ARGS__)
+
+#define VIR_REFLECT_LIGHT_FOR_EACH(op, ...)                                                        \
+  __VA_OPT__(VIR_REFLECT_LIGHT_CALL(                                                               \
+               VIR_REFLECT_LIGHT_SELECT(VIR_REFLECT_LIGHT_ARG33(                                   \
+                 __VA_ARGS__, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, \
+                 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)),                                                   \
+               op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH_SHORT(op, ...) VIR_REFLECT_LIGHT_FOR_EACH0(op, __VA_ARGS__)
+// The first chunk is handled outside of VIR_REFLECT_LIGHT_EXPAND so that it is not rescanned.
+#define VIR_REFLECT_LIGHT_FOR_EACH_LONG(op, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12,     \
+                                        _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23,     \
+                                        _24, _25, _26, _27, _28, _29, _30, _31, _32, ...)          \
+  op(_1), op(_2), op(_3), op(_4), op(_5), op(_6), op(_7), op(_8), op(_9), op(_10), op(_11),        \
+  op(_12), op(_13), op(_14), op(_15), op(_16), op(_17), op(_18), op(_19), op(_20), op(_21),        \
+  op(_22), op(_23), op(_24), op(_25), op(_26), op(_27), op(_28), op(_29), op(_30), op(_31),        \
+  op(_32), VIR_REFLECT_LIGHT_EXPAND(VIR_REFLECT_LIGHT_FOR_EACH0(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH_AGAIN() VIR_REFLECT_LIGHT_FOR_EACH0
+#define VIR_REFLECT_LIGHT_FOR_EACH0(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH1(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH1(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH2(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH2(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH3(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH3(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH4(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH4(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH5(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH5(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH6(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH6(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH7(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH7(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH8(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH8(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH9(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH9(op, x, ...) op(x)                                              \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH10(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH10(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH11(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH11(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH12(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH12(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH13(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH13(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH14(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH14(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH15(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH15(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH16(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH16(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH17(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH17(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH18(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH18(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH19(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH19(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH20(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH20(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH21(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH21(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH22(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH22(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH23(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH23(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH24(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH24(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH25(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH25(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH26(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH26(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH27(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH27(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH28(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH28(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH29(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH29(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH30(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH30(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH31(op, __VA_ARGS__))
+#define VIR_REFLECT_LIGHT_FOR_EACH31(op, x, ...) op(x)                                             \
+  __VA_OPT__(, VIR_REFLECT_LIGHT_FOR_EACH_AGAIN VIR_REFLECT_LIGHT_PARENS(op, __VA_ARGS__))
+
+#define VIR_REFLECT_LIGHT_TO_STRING(x) ::vir::constexpr_string<#x>()
+#define VIR_REFLECT_LIGHT_DECLTYPE(x) decltype(x)
+// static data members have no offset (and offsetof would be ill-formed)
+#define VIR_REFLECT_LIGHT_OFFSETOF(x)                                                              \
+  [] {                                                                                             \
+    if constexpr (requires {                                                                       \
+                    requires vir::refl::detail::is_pointer_v<decltype(&VirRefl_Self::x)>;          \
+                  })                                                                               \
+      return vir::refl::detail::no_offset;                                                         \
+    else                                                                                           \
+      return __builtin_offsetof(VirRefl_Self, x);                                                  \
+  }()
+
+// offsetof is conditionally-supported for classes that are not standard-layout (e.g. when base
+// class and derived class both have data members). GCC and clang support it for all data members
+// that are not members of a virtual base class, but warn.
+#ifdef __GNUC__
+#define VIR_REFLECT_LIGHT_OFFSETOF_BEGIN                                                           \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+#define VIR_REFLECT_LIGHT_OFFSETOF_END _Pragma("GCC diagnostic pop")
+#else
+#define VIR_REFLECT_LIGHT_OFFSETOF_BEGIN
+#define VIR_REFLECT_LIGHT_OFFSETOF_END
+#endif
+
+#define VIR_MAKE_REFLECTABLE(T, ...)                                                               \
+  VIR_REFLECT_LIGHT_BASE_DISCOVERY(T)                                                              \
+  VIR_REFLECT_LIGHT_DATA_MEMBERS(T, __VA_ARGS__)
+
+// Base needs to be the nearest reflectable base class of T or void. base_type<T> then is Base and
+// needs no overload resolution over the vir_refl_determine_base_type friends of the hierarchy.
+// The friends are still declared so that classes using VIR_MAKE_REFLECTABLE can derive from T.
+#define VIR_MAKE_REFLECTABLE_WITH_BASE(T, Base, ...)                                               \
+  VIR_REFLECT_LIGHT_BASE_DISCOVERY(T)                                                              \
+  using vir_refl_explicit_base = vir::refl::detail::explicit_base<T, Base>;                        \
+  VIR_REFLECT_LIGHT_DATA_MEMBERS(T, __VA_ARGS__)
+
+#define VIR_REFLECT_LIGHT_BASE_DISCOVERY(T)                                                        \
+  friend void                                                                                      \
+  vir_refl_determine_base_type(T const&, ...)                                                      \
+  {}                                                                                               \
+                                                                                                   \
+  template <vir::refl::detail::derived_from<T> VirRefl_U>                                          \
+    requires (not vir::refl::detail::is_same_v<VirRefl_U, T>)                                      \
+      and vir::refl::detail::is_void_v<decltype(vir_refl_determine_base_type(                      \
+                                         vir::refl::detail::declval<                               \
+                                           vir::refl::detail::make_dependent_t<VirRefl_U, T>>(),   \
+                                         0))>                                                      \
+    friend T                                                                                       \
+    vir_refl_determine_base_type(VirRefl_U const&, int)                                            \
+    { return vir::refl::detail::declval<T>(); }                                                    \
+                                                                                                   \
+  template <vir::refl::detail::derived_from<T> VirRefl_U, typename VirRefl_Not>                    \
+    requires (not vir::refl::detail::is_same_v<VirRefl_U, T>)                                      \
+      and (not vir::refl::detail::derived_from<VirRefl_Not, T>)                                    \
+      and vir::refl::detail::is_void_v<decltype(vir_refl_determine_base_type(                      \
+                                         vir::refl::detail::declval<                               \
+                                           vir::refl::detail::make_dependent_t<VirRefl_U, T>>(),   \
+                                         vir::refl::detail::declval<VirRefl_Not>()))>              \
+    friend T                                                                                       \
+    vir_refl_determine_base_type(VirRefl_U const&, VirRefl_Not const&)                             \
+    { return vir::refl::detail::declval<T>(); }
+
+#define VIR_REFLECT_LIGHT_DATA_MEMBERS(T, ...)                                                     \
+  using vir_refl_class_name = vir::constexpr_string<#T>;                                           \
+                                                                                                   \
+  constexpr auto                                                                                   \
+  vir_refl_members_as_tuple() &                                                                    \
+  { return vir::tie(__VA_ARGS__); }                                                                \
+                                                                                                   \
+  constexpr auto                                                                                   \
+  vir_refl_members_as_tuple() const&                                                               \
+  { return vir::tie(__VA_ARGS__); }                                                                \
+                                                                                                   \
+  using vir_refl_data_member_types                                                                 \
+    = vir::simple_tuple<VIR_REFLECT_LIGHT_FOR_EACH(VIR_REFLECT_LIGHT_DECLTYPE, __VA_ARGS__)>;      \
+                                                                                                   \
+  static constexpr decltype(vir::refl::detail::tuple_size_of(                                      \
+                              static_cast<vir_refl_data_member_types*>(nullptr)))                  \
+    vir_refl_data_member_count {};                                                                 \
+                                                                                                   \
+  VIR_REFLECT_LIGHT_OFFSETOF_BEGIN                                                                 \
+  template <typename VirRefl_Self = T>                                                             \
+    static constexpr auto                                                                          \
+    vir_refl_data_member_offsets()                                                                 \
+    {                                                                                              \
+      return vir::simple_tuple{                                                                    \
+               VIR_REFLECT_LIGHT_FOR_EACH(VIR_REFLECT_LIGHT_OFFSETOF, __VA_ARGS__)};               \
+    }                                                                                              \
+  VIR_REFLECT_LIGHT_OFFSETOF_END                                                                   \
+                                                                                                   \
+  static constexpr auto vir_refl_data_member_names                                                 \
+    = vir::simple_tuple{VIR_REFLECT_LIGHT_FOR_EACH(VIR_REFLECT_LIGHT_TO_STRING, __VA_ARGS__)}
+
+#endif  // VIR_REFLECT_LIGHT_MACROS_H_
@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_SCHEMA_H_
+#define VIR_REFLECT_LIGHT_SCHEMA_H_
+
+#include "reflect-light-serialize.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Schema evolution for the serialize format.
+//
+// A writer stores schema_of<T>() (e.g. serialized at the start of a file or stream) followed by
+// serialize(obj, ...) records. A reader with a different version of T builds a schema_loader<T>
+// from the stored schema once. The loader matches the stored data members to the data members
+// of T by name and records for every stored data member either its index in T or how to skip
+// its encoding. Decoding a record then follows that table, without looking at names: data
+// members of T that are not stored are copied from a value-initialized T (i.e. they get their
+// default member initializer), stored data members that T does not have are skipped.
+//
+// Limitation: skipping needs the size of the encoding, either fixed or the element count times a
+// fixed element size (strings and vectors of fixed size types). A removed data member whose
+// encoding size is only known by decoding it (e.g. a nested reflectable type with a string, or a
+// vector of strings) cannot be skipped. A single such data member makes the whole loader invalid,
+// i.e. records of that stored schema cannot be loaded at all.
+
+namespace vir::refl
+{
+  // The description of a data member in a stored schema.
+  struct member_schema
+  {
+    std::string name;
+    std::string type;
+    // The type_name and structure of the type (see schema_hash), i.e. it differs if the data
+    // members of a reflectable type or the element type of an array / range changed.
+    std::uint64_t type_hash;
+    // The size of the encoding, or the size of one element of a string / vector (whose encoding
+    // is the number of elements followed by the elements). The unknown size is
+    // std::uint64_t(-1), i.e. a data member with size == element_size == -1 cannot be skipped.
+    std::uint64_t size;
+    std::uint64_t element_size;
+
+    VIR_MAKE_REFLECTABLE(member_schema, name, type, type_hash, size, element_size);
+
+    friend constexpr bool
+    operator==(const member_schema&, const member_schema&) = default;
+  };
+
+  // The description of the serialize encoding of a reflectable type.
+  struct record_schema
+  {
+    std::string class_name;
+    std::vector<member_schema> members;
+
+    VIR_MAKE_REFLECTABLE(record_schema, class_name, members);
+
+    friend constexpr bool
+    operator==(const record_schema&, const record_schema&) = default;
+  };
+
+  namespace detail
+  {
+    // The class name, data member names, and type names of T concatenated into a single constant
+    // (instead of one object per string).
+    template <typename T>
+      constexpr auto schema_strings = []<size_t... Is>(std::index_sequence<Is...>) {
+        return (class_name<T> + ...
+                  + (data_member_name<T, Is> + type_name<data_member_type<T, Is>>));
+      }(std::make_index_sequence<data_member_count<T>>());
+
+    template <typename T>
+      constexpr std::uint64_t serial_element_size = [] {
+        if constexpr (serial_string<T>::value or serial_vector<T>::value)
+          return std::uint64_t(serial_fixed_size<typename T::value_type>);
+        else
+          return std::uint64_t(serial_dynamic_size);
+      }();
+
+    template <typename T>
+      consteval std::uint64_t
+      member_type_hash()
+      { return schema_hash_of<T>(fnv1a_field(type_name<T>.view(), fnv1a({}))); }
+
+    // Assigns data member Idx of from to data member Idx of to.
+    template <typename T>
+      constexpr auto assign_member_table = []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<void (*)(T&, const T&), sizeof...(Is)> {
+          [](T& to, const T& from) { data_member<Is>(to) = data_member<Is>(from); }...
+        };
+      }(std::make_index_sequence<data_member_count<T>>());
+  }
+
+  // The schema of the serialize encoding of T: class_name<T> and the name, type_name, type hash,
+  // and encoding size of every data member (including those of base classes).
+  template <reflectable T>
+    constexpr record_schema
+    schema_of()
+    {
+      std::string_view strings = detail::schema_strings<T>.view();
+      const auto next = [&](size_t n) {
+        std::string str(strings.substr(0, n));
+        strings.remove_prefix(n);
+        return str;
+      };
+      record_schema schema {next(class_name<T>.size()), {}};
+      [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (schema.members.push_back({next(data_member_name<T, Is>.size()),
+                                   next(type_name<data_member_type<T, Is>>.size()),
+                                   detail::member_type_hash<data_member_type<T, Is>>(),
+                                   detail::serial_fixed_size<data_member_type<T, Is>>,
+                                   detail::serial_element_size<data_member_type<T, Is>>}), ...);
+      }(std::make_index_sequence<data_member_count<T>>());
+      return schema;
+    }
+
+  // Decodes records of T that were serialized with a different version of T, described by the
+  // stored schema. The stored data members are matched to the data members of T by name, and
+  // matching data members must have the same type_name, type hash, and size. The class names
+  // are not compared.
+  template <reflectable T>
+    class schema_loader
+    {
+      static constexpr std::uint32_t skip = std::uint32_t(-1);
+
+      // one step per stored data member
+      struct step
+      {
+        // the index of the data member in T, or skip
+        std::uint32_t member;
+        std::uint64_t size;
+        std::uint64_t element_size;
+      };
+
+      std::vector<step> steps_;
+      // the data members of T that are not stored
+      std::vector<std::uint32_t> defaults_;
+      // the source of the data members in defaults_
+      T initial_ {};
+      bool valid_ = false;
+      // the stored schema is schema_of<T>(), i.e. deserialize can be used
+      bool identity_ = false;
+
+    public:
+      // valid() is false if a data member of T is stored with a different type (type_name or
+      // structure) or size, if a name is stored twice, or if a stored data member that T does not
+      // have cannot be skipped.
+      constexpr explicit
+      schema_loader(const record_schema& stored)
+      {
+        constexpr size_t N = data_member_count<T>;
+        const record_schema schema = schema_of<T>();
+        identity_ = stored.members == schema.members;
+        std::array<bool, N> found = {};
+        for (const member_schema& m : stored.members)
+          {
+            size_t idx = size_t(-1);
+            if constexpr (N != 0)
+              idx = detail::name_hash<T>.find(m.name);
+            if (idx == size_t(-1))
+              {
+                if (m.size == detail::serial_dynamic_size
+                      and m.element_size == detail::serial_dynamic_size)
+                  return;
+                steps_.push_back({skip, m.size, m.element_size});
+              }
+            else
+              {
+                const member_schema& expected = schema.members[idx];
+                if (found[idx] or m.type != expected.type or m.type_hash != expected.type_hash
+                      or m.size != expected.size or m.element_size != expected.element_size)
+                  return;
+                found[idx] = true;
+                steps_.push_back({std::uint32_t(idx), m.size, m.element_size});
+              }
+          }
+        for (size_t i = 0; i < N; ++i)
+          if (not found[i])
+            defaults_.push_back(std::uint32_t(i));
+        valid_ = true;
+      }
+
+      constexpr bool
+      valid() const
+      { return valid_; }
+
+      // Reads obj from the front of buffer, which holds a record serialized with the stored
+      // schema, and returns the number of bytes consumed. Returns 0 if buffer ends prematurely or
+      // if the loader is not valid(); obj is partially overwritten in that case.
+      constexpr size_t
+      load(T& obj, std::span<const std::byte> buffer) const
+      {
+        if (not valid_)
+          return 0;
+        if (identity_)
+          return deserialize(obj, buffer);
+        detail::serial_reader in {buffer.data(), buffer.data() + buffer.size()};
+        if constexpr (data_member_count<T> != 0)
+          {
+            for (std::uint32_t idx : defaults_)
+              detail::assign_member_table<T>[idx](obj, initial_);
+            for (const step& s : steps_)
+              {
+                if (s.member != skip)
+                  {
+                    if (not visit_data_member(obj, size_t(s.member), [&](auto& x) {
+                                                return detail::deserialize_value(in, x);
+                                              }))
+                      return 0;
+                  }
+                else
+                  {
+                    std::uint64_t size = s.size;
+                    if (size == detail::serial_dynamic_size)
+                      {
+                        std::uint64_t n = 0;
+                        if (not in.raw(&n, 1))
+                          return 0;
+                        // checked before the multiplication, which could overflow otherwise
+                        if (s.element_size != 0 and size_t(in.end - in.ptr) / s.element_size < n)
+                          return 0;
+                        size = n * s.element_size;
+                      }
+                    if (size_t(in.end - in.ptr) < size)
+                      return 0;
+                    in.ptr += size;
+                  }
+              }
+          }
+        return size_t(in.ptr - buffer.data());
+      }
+    };
+}
+
+#endif  // VIR_REFLECT_LIGHT_SCHEMA_H_
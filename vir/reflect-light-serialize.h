@@ -0,0 +1,609 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_REFLECT_LIGHT_SERIALIZE_H_
+#define VIR_REFLECT_LIGHT_SERIALIZE_H_
+
+#include "reflect-light.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary serialization of reflectable types.
+//
+// The wire format is the concatenation of the encodings of all data members (including those of
+// base classes) in data member index order:
+// - trivially copyable types: their object representation
+// - reflectable types: recursively
+// - std::basic_string / std::vector: the number of elements as std::uint64_t, followed by the
+//   encoding of the elements
+//
+// Integers and floating-point values use the native representation, i.e. the format is not
+// portable between platforms with different endianness or type sizes.
+//
+// Consecutive trivially copyable data members without padding in between (see data_member_runs)
+// are copied with a single memcpy.
+//
+// view<T> provides access to single data members of a serialized T without deserializing it.
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    template <typename T>
+      struct serial_string
+      : std::false_type
+      {};
+
+    template <typename C, typename Tr, typename A>
+      requires std::is_trivially_copyable_v<C>
+      struct serial_string<std::basic_string<C, Tr, A>>
+      : std::true_type
+      {};
+
+    template <typename T>
+      struct serial_vector
+      : std::false_type
+      {};
+
+    template <typename V, typename A>
+      requires (not std::is_same_v<V, bool>)
+      struct serial_vector<std::vector<V, A>>
+      : std::true_type
+      {};
+
+    template <typename T>
+      consteval bool
+      is_dense_reflectable();
+
+    // T is encoded as its object representation. For reflectable types this is only the case if
+    // the member-wise encoding is identical, i.e. all data members are raw and no padding exists.
+    template <typename T>
+      constexpr bool serial_raw = [] {
+        if constexpr (not std::is_trivially_copyable_v<T>)
+          return false;
+        else if constexpr (reflectable<T>)
+          return is_dense_reflectable<T>();
+        else
+          return true;
+      }();
+
+    template <typename T>
+      struct is_serial_raw
+      : std::bool_constant<serial_raw<T>>
+      {};
+
+    template <typename T>
+      consteval bool
+      is_dense_reflectable()
+      {
+        if constexpr (not checked_layout<T>().valid)
+          return false;
+        else
+          {
+            constexpr auto runs = make_runs<T, is_serial_raw>();
+            return runs.size() == 1 and runs[0].count == data_member_count<T>
+                     and runs[0].size == sizeof(T);
+          }
+      }
+
+    // The number of bytes to copy starting at data member i. Zero if i is not raw or if i is
+    // copied as part of a preceding run.
+    template <typename T>
+      constexpr auto serial_blocks = [] {
+        std::array<size_t, data_member_count<T>> r = {};
+        if constexpr (checked_layout<T>().valid)
+          {
+            for (const data_member_run& run : make_runs<T, is_serial_raw>())
+              r[run.first] = run.size;
+          }
+        else
+          {
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+              ((r[Is] = serial_raw<data_member_type<T, Is>> ? sizeof(data_member_type<T, Is>) : 0),
+               ...);
+            }(std::make_index_sequence<data_member_count<T>>());
+          }
+        return r;
+      }();
+
+    // The smallest number of bytes the encoding of a T can have.
+    template <typename T>
+      consteval size_t
+      serial_min_size()
+      {
+        if constexpr (serial_raw<T>)
+          return sizeof(T);
+        else if constexpr (reflectable<T>)
+          return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return (size_t() + ... + serial_min_size<data_member_type<T, Is>>());
+          }(std::make_index_sequence<data_member_count<T>>());
+        else
+          return sizeof(std::uint64_t);
+      }
+
+    // Copies the object representation of n objects of raw type T.
+    template <typename T>
+      constexpr void
+      store_raw(std::byte* dst, const T* src, size_t n)
+      {
+        if (std::is_constant_evaluated())
+          {
+            for (size_t i = 0; i < n; ++i)
+              {
+                const auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(src[i]);
+                for (size_t j = 0; j < sizeof(T); ++j)
+                  *dst++ = bytes[j];
+              }
+          }
+        else if (n != 0)
+          std::memcpy(dst, src, n * sizeof(T));
+      }
+
+    // Arrays (e.g. an array data member of a padded class) are loaded element by element in
+    // constant evaluation, since they cannot be the target of an assignment or a bit_cast.
+    template <typename T>
+      constexpr void
+      load_raw(T* dst, const std::byte* src, size_t n)
+      {
+        if (std::is_constant_evaluated())
+          {
+            if constexpr (std::is_array_v<T>)
+              {
+                for (size_t i = 0; i < n; ++i)
+                  load_raw(dst[i], src + i * sizeof(T), std::extent_v<T>);
+              }
+            else
+              {
+                for (size_t i = 0; i < n; ++i)
+                  {
+                    std::array<std::byte, sizeof(T)> bytes = {};
+                    for (size_t j = 0; j < sizeof(T); ++j)
+                      bytes[j] = *src++;
+                    dst[i] = std::bit_cast<T>(bytes);
+                  }
+              }
+          }
+        else if (n != 0)
+          std::memcpy(dst, src, n * sizeof(T));
+      }
+
+    // Counts the bytes instead of writing them.
+    struct serial_counter
+    {
+      size_t size = 0;
+
+      template <typename T>
+        constexpr bool
+        raw(const T*, size_t n)
+        {
+          size += n * sizeof(T);
+          return true;
+        }
+
+      constexpr bool
+      block(const std::byte*, size_t n)
+      {
+        size += n;
+        return true;
+      }
+    };
+
+    struct serial_writer
+    {
+      std::byte* ptr;
+      std::byte* const end;
+
+      template <typename T>
+        constexpr bool
+        raw(const T* src, size_t n)
+        {
+          if (size_t(end - ptr) / sizeof(T) < n)
+            return false;
+          store_raw(ptr, src, n);
+          ptr += n * sizeof(T);
+          return true;
+        }
+
+      bool
+      block(const std::byte* src, size_t n)
+      {
+        if (size_t(end - ptr) < n)
+          return false;
+        std::memcpy(ptr, src, n);
+        ptr += n;
+        return true;
+      }
+    };
+
+    struct serial_reader
+    {
+      const std::byte* ptr;
+      const std::byte* const end;
+
+      // Returns whether n objects of type T can still be read.
+      template <typename T>
+        constexpr bool
+        has(std::uint64_t n) const
+        { return size_t(end - ptr) / sizeof(T) >= n; }
+
+      template <typename T>
+        constexpr bool
+        raw(T* dst, size_t n)
+        {
+          if (not has<T>(n))
+            return false;
+          load_raw(dst, ptr, n);
+          ptr += n * sizeof(T);
+          return true;
+        }
+
+      bool
+      block(std::byte* dst, size_t n)
+      {
+        if (size_t(end - ptr) < n)
+          return false;
+        std::memcpy(dst, ptr, n);
+        ptr += n;
+        return true;
+      }
+    };
+
+    template <typename T>
+      constexpr bool
+      serialize_value(auto& out, const T& x)
+      {
+        if constexpr (serial_raw<T>)
+          return out.raw(std::addressof(x), 1);
+        else if constexpr (reflectable<T>)
+          {
+            return [&]<size_t... Is>(std::index_sequence<Is...>) {
+              return ([&] {
+                constexpr size_t block = serial_blocks<T>[Is];
+                if constexpr (not serial_raw<data_member_type<T, Is>>)
+                  return serialize_value(out, data_member<Is>(x));
+                else if (std::is_constant_evaluated())
+                  return out.raw(std::addressof(data_member<Is>(x)), 1);
+                else if constexpr (block == 0)
+                  return true;
+                else if constexpr (checked_layout<T>().valid)
+                  return out.block(reinterpret_cast<const std::byte*>(std::addressof(x))
+                                     + layout<T>.offsets[Is], block);
+                else
+                  return out.raw(std::addressof(data_member<Is>(x)), 1);
+              }() and ...);
+            }(std::make_index_sequence<data_member_count<T>>());
+          }
+        else if constexpr (serial_string<T>::value or serial_vector<T>::value)
+          {
+            const std::uint64_t n = x.size();
+            if (not out.raw(&n, 1))
+              return false;
+            if constexpr (serial_raw<typename T::value_type>)
+              return out.raw(x.data(), x.size());
+            else
+              {
+                for (const auto& element : x)
+                  if (not serialize_value(out, element))
+                    return false;
+                return true;
+              }
+          }
+        else
+          static_assert(serial_raw<T>, "vir::refl::serialize: unsupported data member type");
+      }
+
+    template <typename T>
+      constexpr bool
+      deserialize_value(serial_reader& in, T& x)
+      {
+        if constexpr (serial_raw<T>)
+          return in.raw(std::addressof(x), 1);
+        else if constexpr (reflectable<T>)
+          {
+            return [&]<size_t... Is>(std::index_sequence<Is...>) {
+              return ([&] {
+                constexpr size_t block = serial_blocks<T>[Is];
+                if constexpr (not serial_raw<data_member_type<T, Is>>)
+                  return deserialize_value(in, data_member<Is>(x));
+                else if (std::is_constant_evaluated())
+                  return in.raw(std::addressof(data_member<Is>(x)), 1);
+                else if constexpr (block == 0)
+                  return true;
+                else if constexpr (checked_layout<T>().valid)
+                  return in.block(reinterpret_cast<std::byte*>(std::addressof(x))
+                                    + layout<T>.offsets[Is], block);
+                else
+                  return in.raw(std::addressof(data_member<Is>(x)), 1);
+              }() and ...);
+            }(std::make_index_sequence<data_member_count<T>>());
+          }
+        else if constexpr (serial_string<T>::value or serial_vector<T>::value)
+          {
+            using V = typename T::value_type;
+            std::uint64_t n = 0;
+            if (not in.raw(&n, 1))
+              return false;
+            if constexpr (serial_raw<V>)
+              {
+                // checked before resize, so that a corrupt size cannot trigger a huge allocation
+                if (not in.has<V>(n))
+                  return false;
+                x.resize(n);
+                return in.raw(x.data(), n);
+              }
+            else
+              {
+                // a corrupt size must not loop beyond the remaining bytes, also if elements need
+                // no bytes (reflectable types without data members)
+                constexpr size_t min_size = std::max(serial_min_size<V>(), size_t(1));
+                if (size_t(in.end - in.ptr) / min_size < n)
+                  return false;
+                x.clear();
+                for (; n > 0; --n)
+                  if (not deserialize_value(in, x.emplace_back()))
+                    return false;
+                return true;
+              }
+          }
+        else
+          static_assert(serial_raw<T>, "vir::refl::deserialize: unsupported data member type");
+      }
+  }
+
+  // Returns the number of bytes serialize(obj, buffer) writes.
+  template <reflectable T>
+    constexpr size_t
+    serialized_size(const T& obj)
+    {
+      detail::serial_counter counter;
+      detail::serialize_value(counter, obj);
+      return counter.size;
+    }
+
+  // Writes obj to the front of buffer and returns the number of bytes written. Returns 0 if
+  // buffer is too small; the contents of buffer are unspecified in that case.
+  template <reflectable T>
+    constexpr size_t
+    serialize(const T& obj, std::span<std::byte> buffer)
+    {
+      detail::serial_writer out {buffer.data(), buffer.data() + buffer.size()};
+      if (not detail::serialize_value(out, obj))
+        return 0;
+      return size_t(out.ptr - buffer.data());
+    }
+
+  // Reads obj from the front of buffer and returns the number of bytes consumed. Returns 0 if
+  // buffer ends prematurely; obj is partially overwritten in that case. Only sizes are validated:
+  // the bytes of trivially copyable members must be valid object representations.
+  template <reflectable T>
+    constexpr size_t
+    deserialize(T& obj, std::span<const std::byte> buffer)
+    {
+      detail::serial_reader in {buffer.data(), buffer.data() + buffer.size()};
+      if (not detail::deserialize_value(in, obj))
+        return 0;
+      return size_t(in.ptr - buffer.data());
+    }
+
+  template <typename T>
+    class view;
+
+  namespace detail
+  {
+    inline constexpr size_t serial_dynamic_size = size_t(-1);
+
+    // The size of the encoding of T, if it does not depend on the value.
+    template <typename T>
+      constexpr size_t serial_fixed_size = [] {
+        if constexpr (serial_raw<T>)
+          return sizeof(T);
+        else if constexpr (reflectable<T>)
+          {
+            return []<size_t... Is>(std::index_sequence<Is...>) {
+              constexpr std::array sizes
+                = {size_t(0), serial_fixed_size<data_member_type<T, Is>>...};
+              size_t sum = 0;
+              for (size_t size : sizes)
+                {
+                  if (size == serial_dynamic_size)
+                    return serial_dynamic_size;
+                  sum += size;
+                }
+              return sum;
+            }(std::make_index_sequence<data_member_count<T>>());
+          }
+        else
+          return serial_dynamic_size;
+      }();
+
+    template <typename T>
+      constexpr T
+      serial_load(const std::byte* p)
+      {
+        std::array<std::byte, sizeof(T)> bytes;
+        if (std::is_constant_evaluated())
+          {
+            for (size_t i = 0; i < sizeof(T); ++i)
+              bytes[i] = p[i];
+          }
+        else
+          std::memcpy(bytes.data(), p, sizeof(T));
+        return std::bit_cast<T>(bytes);
+      }
+
+    template <typename T, size_t Idx>
+      constexpr size_t
+      serial_member_offset(const std::byte* p);
+
+    // The size of the encoding of the T at p.
+    template <typename T>
+      constexpr size_t
+      serial_skip(const std::byte* p)
+      {
+        if constexpr (serial_fixed_size<T> != serial_dynamic_size)
+          return serial_fixed_size<T>;
+        else if constexpr (reflectable<T>)
+          return serial_member_offset<T, data_member_count<T>>(p);
+        else
+          {
+            using V = typename T::value_type;
+            const auto n = serial_load<std::uint64_t>(p);
+            if constexpr (serial_fixed_size<V> != serial_dynamic_size)
+              return sizeof(n) + n * serial_fixed_size<V>;
+            else
+              {
+                size_t offset = sizeof(n);
+                for (std::uint64_t i = 0; i < n; ++i)
+                  offset += serial_skip<V>(p + offset);
+                return offset;
+              }
+          }
+      }
+
+    // The offsets of the encodings of the data members of T (and of the end), as long as they
+    // do not depend on the value.
+    template <typename T>
+      constexpr auto serial_fixed_offsets = [] {
+        std::array<size_t, data_member_count<T> + 1> r = {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          constexpr std::array sizes = {size_t(0), serial_fixed_size<data_member_type<T, Is>>...};
+          for (size_t i = 1; i < r.size(); ++i)
+            r[i] = r[i - 1] == serial_dynamic_size or sizes[i] == serial_dynamic_size
+                     ? serial_dynamic_size : r[i - 1] + sizes[i];
+        }(std::make_index_sequence<data_member_count<T>>());
+        return r;
+      }();
+
+    // The offset of the encoding of data member Idx within the encoding of the T at p. Only the
+    // data members with dynamic size in front of Idx (and all after them) need to be skipped.
+    template <typename T, size_t Idx>
+      constexpr size_t
+      serial_member_offset(const std::byte* p)
+      {
+        constexpr size_t first = [] {
+          size_t k = Idx;
+          while (serial_fixed_offsets<T>[k] == serial_dynamic_size)
+            --k;
+          return k;
+        }();
+        size_t offset = serial_fixed_offsets<T>[first];
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((offset += serial_skip<data_member_type<T, first + Is>>(p + offset)), ...);
+        }(std::make_index_sequence<Idx - first>());
+        return offset;
+      }
+
+    // Returns the T at p by value, or a view if T has no fixed size.
+    template <typename T>
+      constexpr auto
+      serial_decode(std::span<const std::byte> data)
+      {
+        if constexpr (serial_raw<T>)
+          return serial_load<T>(data.data());
+        else if constexpr (serial_string<T>::value)
+          {
+            using C = typename T::value_type;
+            static_assert(sizeof(C) == 1, "vir::refl::view: only strings of bytes can be viewed");
+            const auto n = serial_load<std::uint64_t>(data.data());
+            return std::basic_string_view<C, typename T::traits_type>(
+                     reinterpret_cast<const C*>(data.data() + sizeof(n)), n);
+          }
+        else
+          return view<T>(data);
+      }
+  }
+
+  // A view of the serialization of a reflectable T (see serialize). data_member<Idx>(v) and
+  // data_member<Name>(v) decode a single data member: trivially copyable types by value, strings
+  // as std::basic_string_view, and reflectable types and vectors as a view.
+  template <typename T>
+    class view
+    {
+      static_assert(reflectable<T>, "vir::refl::view<T> requires a reflectable T or a vector");
+
+      std::span<const std::byte> data_;
+
+    public:
+      using value_type = T;
+
+      // Precondition: data starts with serialize(T{...}, ...) output.
+      constexpr explicit
+      view(std::span<const std::byte> data)
+        : data_(data)
+      {}
+
+      // The serialization of the viewed object.
+      constexpr std::span<const std::byte>
+      bytes() const
+      { return data_.first(detail::serial_skip<T>(data_.data())); }
+
+      template <size_t Idx>
+        constexpr auto
+        member() const
+        {
+          using M = data_member_type<T, Idx>;
+          return detail::serial_decode<M>(
+                   data_.subspan(detail::serial_member_offset<T, Idx>(data_.data())));
+        }
+    };
+
+  template <typename V, typename A>
+    class view<std::vector<V, A>>
+    {
+      std::span<const std::byte> data_;
+
+    public:
+      using value_type = std::vector<V, A>;
+
+      constexpr explicit
+      view(std::span<const std::byte> data)
+        : data_(data)
+      {}
+
+      constexpr std::span<const std::byte>
+      bytes() const
+      { return data_.first(detail::serial_skip<value_type>(data_.data())); }
+
+      constexpr size_t
+      size() const
+      { return detail::serial_load<std::uint64_t>(data_.data()); }
+
+      constexpr bool
+      empty() const
+      { return size() == 0; }
+
+      // Decodes element i. Linear in i if V has no fixed size.
+      constexpr auto
+      operator[](size_t i) const
+      {
+        size_t offset = sizeof(std::uint64_t);
+        if constexpr (detail::serial_fixed_size<V> != detail::serial_dynamic_size)
+          offset += i * detail::serial_fixed_size<V>;
+        else
+          for (; i > 0; --i)
+            offset += detail::serial_skip<V>(data_.data() + offset);
+        return detail::serial_decode<V>(data_.subspan(offset));
+      }
+    };
+
+  template <size_t Idx, typename T>
+    constexpr auto
+    data_member(const view<T>& v)
+    { return v.template member<Idx>(); }
+
+  template <fixed_string Name, typename T>
+    constexpr auto
+    data_member(const view<T>& v)
+    { return v.template member<data_member_index<T, Name>>(); }
+}
+
+#endif  // VIR_REFLECT_LIGHT_SERIALIZE_H_
@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+// The vir.reflect_light module. Importers additionally include <vir/reflect-light-macros.h> for
+// VIR_MAKE_REFLECTABLE / VIR_MAKE_REFLECTABLE_WITH_BASE.
+
+module;
+
+// All standard headers used by vir/*.h need to be in the global module fragment.
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#ifdef _MSC_VER
+#include <vector>
+#endif
+
+export module vir.reflect_light;
+
+// extern "C++" keeps the declarations attached to the global module, i.e. they are the same
+// entities as declared by #include <vir/reflect-light.h> in other translation units.
+export extern "C++"
+{
+#include "reflect-light.h"
+}
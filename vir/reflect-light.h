@@ -8,95 +8,60 @@
 
 #include "fixed_string.h"
 #include "simple_tuple.h"
+#include "reflect-light-macros.h"
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #ifdef _MSC_VER
 #include <vector> // for type_name specialization
 #endif
 #include <string>
 
-// recursive macro implementation inspired by https://www.scs.stanford.edu/~dm/blog/va-opt.html
-
-#define VIR_REFLECT_LIGHT_PARENS ()
-#define VIR_REFLECT_LIGHT_EXPAND(...) VIR_REFLECT_LIGHT_EXPAND3(VIR_REFLECT_LIGHT_EXPAND3(         \
-                                        VIR_REFLECT_LIGHT_EXPAND3(VIR_REFLECT_LIGHT_EXPAND3(       \
-                                          __VA_ARGS__))))
-#define VIR_REFLECT_LIGHT_EXPAND3(...) VIR_REFLECT_LIGHT_EXPAND2(VIR_REFLECT_LIGHT_EXPAND2(        \
-                                         VIR_REFLECT_LIGHT_EXPAND2(VIR_REFLECT_LIGHT_EXPAND2(      \
-                                           __VA_ARGS__))))
-#define VIR_REFLECT_LIGHT_EXPAND2(...) VIR_REFLECT_LIGHT_EXPAND1(VIR_REFLECT_LIGHT_EXPAND1(        \
-                                         VIR_REFLECT_LIGHT_EXPAND1(VIR_REFLECT_LIGHT_EXPAND1(      \
-                                           __VA_ARGS__))))
-#define VIR_REFLECT_LIGHT_EXPAND1(...) __VA_ARGS__
-
-#define VIR_REFLECT_LIGHT_TO_STRINGS(...)                                                          \
-  __VA_OPT__(VIR_REFLECT_LIGHT_EXPAND(VIR_REFLECT_LIGHT_TO_STRINGS_IMPL(__VA_ARGS__)))
-#define VIR_REFLECT_LIGHT_TO_STRINGS_IMPL(x, ...) ::vir::constexpr_string<#x>()                        \
-  __VA_OPT__(, VIR_REFLECT_LIGHT_TO_STRINGS_AGAIN VIR_REFLECT_LIGHT_PARENS(__VA_ARGS__))
-#define VIR_REFLECT_LIGHT_TO_STRINGS_AGAIN() VIR_REFLECT_LIGHT_TO_STRINGS_IMPL
-
-#define VIR_REFLECT_LIGHT_COUNT_ARGS(...)                                                          \
-  0 __VA_OPT__(+ VIR_REFLECT_LIGHT_EXPAND(VIR_REFLECT_LIGHT_COUNT_ARGS_IMPL(__VA_ARGS__)))
-#define VIR_REFLECT_LIGHT_COUNT_ARGS_IMPL(x, ...) 1                                                \
-  __VA_OPT__(+ VIR_REFLECT_LIGHT_COUNT_ARGS_AGAIN VIR_REFLECT_LIGHT_PARENS(__VA_ARGS__))
-#define VIR_REFLECT_LIGHT_COUNT_ARGS_AGAIN() VIR_REFLECT_LIGHT_COUNT_ARGS_IMPL
-
-#define VIR_REFLECT_LIGHT_DECLTYPES(...)                                                           \
-  __VA_OPT__(VIR_REFLECT_LIGHT_EXPAND(VIR_REFLECT_LIGHT_DECLTYPES_IMPL(__VA_ARGS__)))
-#define VIR_REFLECT_LIGHT_DECLTYPES_IMPL(x, ...) decltype(x)                                       \
-  __VA_OPT__(, VIR_REFLECT_LIGHT_DECLTYPES_AGAIN VIR_REFLECT_LIGHT_PARENS(__VA_ARGS__))
-#define VIR_REFLECT_LIGHT_DECLTYPES_AGAIN() VIR_REFLECT_LIGHT_DECLTYPES_IMPL
-
 namespace vir::refl::detail
 {
+  // The VIR_MAKE_REFLECTABLE expansion uses these instead of their std counterparts, so that
+  // importers of the vir.reflect_light module don't need to include any standard headers.
+  template <typename T>
+    std::add_rvalue_reference_t<T>
+    declval() noexcept; // not defined
+
+  template <typename T, typename U>
+    concept derived_from = std::derived_from<T, U>;
+
+  template <typename T, typename U>
+    inline constexpr bool is_same_v = std::is_same_v<T, U>;
+
+  template <typename T>
+    inline constexpr bool is_void_v = std::is_void_v<T>;
+
+  template <typename T>
+    inline constexpr bool is_pointer_v = std::is_pointer_v<T>;
+
+  // the "offset" of a static data member
+  inline constexpr std::size_t no_offset = std::size_t(-1);
+
   template <typename T, typename U>
     struct make_dependent
     { using type = U; };
 
   template <typename T, typename U>
     using make_dependent_t = typename make_dependent<T, U>::type;
-}
 
-#define VIR_MAKE_REFLECTABLE(T, ...)                                                               \
-  friend void                                                                                      \
-  vir_refl_determine_base_type(T const&, ...)                                                      \
-  {}                                                                                               \
-                                                                                                   \
-  template <std::derived_from<T> VirRefl_U>                                                        \
-    requires (not std::is_same_v<VirRefl_U, T>)                                                    \
-      and std::is_void_v<decltype(vir_refl_determine_base_type(                                    \
-                                    std::declval<vir::refl::detail::make_dependent_t<              \
-                                                   VirRefl_U, T>>(), 0))>                          \
-    friend T                                                                                       \
-    vir_refl_determine_base_type(VirRefl_U const&, int)                                            \
-    { return std::declval<T>(); }                                                                  \
-                                                                                                   \
-  template <std::derived_from<T> VirRefl_U, typename VirRefl_Not>                                  \
-    requires (not std::is_same_v<VirRefl_U, T>) and (not std::derived_from<VirRefl_Not, T>)        \
-      and std::is_void_v<decltype(vir_refl_determine_base_type(                                    \
-                                    std::declval<vir::refl::detail::make_dependent_t<              \
-                                                   VirRefl_U, T>>(), std::declval<VirRefl_Not>()))>\
-    friend T                                                                                       \
-    vir_refl_determine_base_type(VirRefl_U const&, VirRefl_Not const&)                             \
-    { return std::declval<T>(); }                                                                  \
-                                                                                                   \
-  using vir_refl_class_name = vir::constexpr_string<#T>;                                               \
-                                                                                                   \
-  constexpr auto                                                                                   \
-  vir_refl_members_as_tuple() &                                                                    \
-  { return vir::tie(__VA_ARGS__); }                                                                \
-                                                                                                   \
-  constexpr auto                                                                                   \
-  vir_refl_members_as_tuple() const&                                                               \
-  { return vir::tie(__VA_ARGS__); }                                                                \
-                                                                                                   \
-  using vir_refl_data_member_types = vir::simple_tuple<VIR_REFLECT_LIGHT_DECLTYPES(__VA_ARGS__)>;  \
-                                                                                                   \
-  static constexpr std::integral_constant<std::size_t, VIR_REFLECT_LIGHT_COUNT_ARGS(__VA_ARGS__)>  \
-    vir_refl_data_member_count {};                                                                 \
-                                                                                                   \
-  static constexpr auto vir_refl_data_member_names                                                 \
-    = vir::simple_tuple{VIR_REFLECT_LIGHT_TO_STRINGS(__VA_ARGS__)}
+  template <typename T, typename Base>
+    struct explicit_base
+    {
+      using derived_type = T;
+      using base_type = Base;
+    };
+
+  // deduces the size without instantiating simple_tuple<Ts...>
+  template <typename... Ts>
+    std::integral_constant<std::size_t, sizeof...(Ts)>
+    tuple_size_of(vir::simple_tuple<Ts...>*);
+}
 
 namespace vir
 {
@@ -113,6 +78,30 @@ namespace vir
         using find_base
           = decltype(vir_refl_determine_base_type(std::declval<T>(), std::declval<Excluding>()));
 
+      // Whether Base, named in VIR_MAKE_REFLECTABLE_WITH_BASE(T, Base, ...), is the nearest
+      // reflectable base class of T (or void and T has no reflectable base class). This needs a
+      // single overload resolution over the vir_refl_determine_base_type friends, not the search
+      // of base_type_impl<T, None>. Returns true if Base is not a reflectable base class of T,
+      // which is diagnosed separately.
+      template <typename T, typename Base>
+        consteval bool
+        is_nearest_base()
+        {
+          if constexpr (std::is_void_v<Base>)
+            {
+              if constexpr (requires { vir_refl_determine_base_type(std::declval<T>(), 0); })
+                return std::is_void_v<decltype(vir_refl_determine_base_type(std::declval<T>(),
+                                                                            0))>;
+              else
+                return true;
+            }
+          else if constexpr (std::derived_from<T, Base> and not std::same_as<T, Base>
+                               and requires { Base::vir_refl_data_member_count; })
+            return std::is_void_v<find_base<T, Base>>;
+          else
+            return true;
+        }
+
       template <typename T, typename Last = None>
         struct base_type_impl
         { using type = void; };
@@ -126,6 +115,29 @@ namespace vir
                                                     std::declval<T>(), 0))>::type;
         };
 
+      // the base type was named via VIR_MAKE_REFLECTABLE_WITH_BASE => no search needed
+      // (the typedef is inherited, thus it must be checked that it was declared for T)
+      template <class_type T>
+        requires std::same_as<typename T::vir_refl_explicit_base::derived_type, T>
+        struct base_type_impl<T, None>
+        {
+          using type = typename T::vir_refl_explicit_base::base_type;
+
+          static_assert(std::is_void_v<type> or (std::derived_from<T, type>
+                                                   and not std::same_as<T, type>),
+                        "VIR_MAKE_REFLECTABLE_WITH_BASE(T, Base, ...) requires Base to be void or "
+                        "a base class of T");
+
+          static_assert(std::is_void_v<type> or requires { type::vir_refl_data_member_count; },
+                        "VIR_MAKE_REFLECTABLE_WITH_BASE(T, Base, ...) requires Base to be void or "
+                        "reflectable");
+
+          // otherwise the data members of the reflectable classes between T and Base are lost
+          static_assert(is_nearest_base<T, type>(),
+                        "VIR_MAKE_REFLECTABLE_WITH_BASE(T, Base, ...) requires Base to be the "
+                        "nearest reflectable base class of T (or void if there is none)");
+        };
+
       // if Last is void => there's no base type (void)
       template <class_type T>
         struct base_type_impl<T, void>
@@ -253,6 +265,15 @@ namespace vir
         }
 
 #undef VIR_PRETTY_FUNCTION
+
+      // 64-bit FNV-1a
+      constexpr std::uint64_t
+      fnv1a(std::string_view str, std::uint64_t hash = 0xcbf29ce484222325u)
+      {
+        for (char c : str)
+          hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3u;
+        return hash;
+      }
     }
 
     template <typename T>
@@ -314,6 +335,9 @@ namespace vir
         = type_name<T>.resize(type_name<T>.find_char(detail::ic<'<'>));
 #endif
 
+    template <typename T>
+      inline constexpr std::uint64_t type_id = detail::fnv1a(type_name<T>.view());
+
     template <typename T>
       using base_type = typename detail::base_type_impl<T>::type;
 
@@ -344,11 +368,123 @@ namespace vir
       constexpr auto data_member_name<T, Idx>
         = T::vir_refl_data_member_names[detail::ic<Idx - data_member_count<base_type<T>>>];
 
+    namespace detail
+    {
+      template <typename... Names>
+        consteval std::array<std::string_view, sizeof...(Names)>
+        names_to_array(const simple_tuple<Names...>*)
+        { return {Names::value.view()...}; }
+
+      // The names of all data members of T (including base classes) in index order.
+      template <typename T>
+        constexpr auto data_member_names = [] {
+          constexpr auto own = names_to_array(&T::vir_refl_data_member_names);
+          if constexpr (std::is_void_v<base_type<T>>)
+            return own;
+          else
+            {
+              constexpr auto& base = data_member_names<base_type<T>>;
+              std::array<std::string_view, base.size() + own.size()> r = {};
+              size_t i = 0;
+              for (std::string_view name : base)
+                r[i++] = name;
+              for (std::string_view name : own)
+                r[i++] = name;
+              return r;
+            }
+        }();
+
+      // Sorted name -> index table. Built once per class so that every name lookup is a binary
+      // search instead of a comparison against every data_member_name<T, Is>.
+      template <size_t N>
+        struct data_member_name_index
+        {
+          std::array<std::string_view, N> names = {};
+
+          std::array<size_t, N> indexes = {};
+
+          constexpr
+          data_member_name_index(const std::array<std::string_view, N>& unsorted)
+          : names(unsorted)
+          {
+            for (size_t i = 0; i < N; ++i)
+              indexes[i] = i;
+            // heapsort by (name, index)
+            for (size_t i = N / 2; i > 0; --i)
+              sift_down(i - 1, N);
+            for (size_t end = N; end > 1; --end)
+              {
+                swap(0, end - 1);
+                sift_down(0, end - 1);
+              }
+          }
+
+          constexpr bool
+          less(size_t a, size_t b) const
+          {
+            return names[a] < names[b] or (names[a] == names[b] and indexes[a] < indexes[b]);
+          }
+
+          constexpr void
+          swap(size_t a, size_t b)
+          {
+            const std::string_view tmp_name = names[a];
+            names[a] = names[b];
+            names[b] = tmp_name;
+            const size_t tmp_idx = indexes[a];
+            indexes[a] = indexes[b];
+            indexes[b] = tmp_idx;
+          }
+
+          constexpr void
+          sift_down(size_t root, size_t end)
+          {
+            for (size_t child = 2 * root + 1; child < end; child = 2 * root + 1)
+              {
+                if (child + 1 < end and less(child, child + 1))
+                  ++child;
+                if (not less(root, child))
+                  return;
+                swap(root, child);
+                root = child;
+              }
+          }
+
+          // returns size_t(-1) if name is not found
+          constexpr size_t
+          find(std::string_view name) const
+          {
+            size_t first = 0;
+            size_t last = N;
+            while (first < last)
+              {
+                const size_t mid = (first + last) / 2;
+                if (names[mid] < name)
+                  first = mid + 1;
+                else
+                  last = mid;
+              }
+            return first < N and names[first] == name ? indexes[first] : size_t(-1);
+          }
+        };
+
+      template <typename T>
+        constexpr data_member_name_index name_index = data_member_names<T>;
+
+      template <typename T>
+        consteval size_t
+        find_data_member_index(std::string_view name)
+        {
+          const size_t idx = name_index<T>.find(name);
+          if (idx == size_t(-1))
+            throw name; // T has no data member with the given name
+          return idx;
+        }
+    }
+
     template <reflectable T, fixed_string Name>
       constexpr auto data_member_index
-        = detail::ic<[]<size_t... Is>(std::index_sequence<Is...>) {
-                      return ((Name == data_member_name<T, Is>.value ? Is : 0) + ...);
-                    }(std::make_index_sequence<data_member_count<T>>())>;
+        = detail::ic<detail::find_data_member_index<T>(Name.view())>;
 
     template <size_t Idx>
       constexpr decltype(auto)
@@ -375,7 +511,228 @@ namespace vir
       if constexpr (std::is_void_v<B>)
         return obj.vir_refl_members_as_tuple();
       else
-        return all_data_members(static_cast<B&>(obj)) + obj.vir_refl_members_as_tuple();
+        return all_data_members(detail::to_base_type(obj)) + obj.vir_refl_members_as_tuple();
+    }
+
+    namespace detail
+    {
+      // Little-endian load of n <= 8 chars
+      constexpr std::uint64_t
+      load_chars(const char* ptr, size_t n)
+      {
+        if constexpr (std::endian::native == std::endian::little)
+          if (not std::is_constant_evaluated() and n == 8)
+            {
+              std::uint64_t word;
+              std::memcpy(&word, ptr, 8);
+              return word;
+            }
+        std::uint64_t word = 0;
+        for (size_t i = 0; i < n; ++i)
+          word |= std::uint64_t(static_cast<unsigned char>(ptr[i])) << (8 * i);
+        return word;
+      }
+
+      // A string hash that processes 8 chars per step (unlike fnv1a, which has a multiplication in
+      // the dependency chain of every char).
+      constexpr std::uint64_t
+      hash_name(std::string_view str)
+      {
+        const size_t size = str.size();
+        const char* ptr = str.data();
+        std::uint64_t hash = size * 0x9e3779b97f4a7c15u;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+          {
+            hash = (hash ^ load_chars(ptr + i, 8)) * 0xff51afd7ed558ccdu;
+            hash ^= hash >> 32;
+          }
+        if (i < size)
+          {
+            // the remaining chars: shift out the already hashed part of the last 8 chars
+            const std::uint64_t tail
+              = size < 8 ? load_chars(ptr, size)
+                         : load_chars(ptr + size - 8, 8) >> (8 * (i + 8 - size));
+            hash = (hash ^ tail) * 0xc4ceb9fe1a85ec53u;
+          }
+        return hash ^ (hash >> 29);
+      }
+
+      // Perfect hash of all data member names of a class (hash and displace): The hash of a
+      // name selects a bucket; the bucket's seed (found at compile time) then maps every name of
+      // the bucket to its own slot. A lookup thus needs one pass over the name, one slot, and one
+      // string comparison.
+      template <size_t N>
+        struct data_member_name_hash
+        {
+          static constexpr size_t bucket_count = std::bit_ceil(N) / 2 + 1;
+
+          static constexpr size_t slot_count = std::bit_ceil(2 * N);
+
+          using index_type = std::conditional_t<(N < 0xffff), std::uint16_t, std::uint32_t>;
+
+          static constexpr index_type empty = index_type(-1);
+
+          std::array<std::string_view, N> names = {};
+
+          std::array<std::uint32_t, bucket_count> seeds = {};
+
+          std::array<index_type, slot_count> slots = {};
+
+          size_t min_size = size_t(-1);
+
+          size_t max_size = 0;
+
+          static constexpr size_t
+          bucket_of(std::uint64_t hash)
+          { return (hash >> 32) % bucket_count; }
+
+          static constexpr size_t
+          slot_of(std::uint64_t hash, std::uint32_t seed)
+          {
+            hash += seed * 0x9e3779b97f4a7c15u;
+            hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdu;
+            return (hash ^ (hash >> 33)) & (slot_count - 1);
+          }
+
+          consteval
+          data_member_name_hash(const std::array<std::string_view, N>& names_in_index_order)
+          : names(names_in_index_order)
+          {
+            for (index_type& slot : slots)
+              slot = empty;
+            std::array<std::uint64_t, N> hashes = {};
+            std::array<size_t, bucket_count + 1> bucket_begin = {};
+            for (size_t idx = 0; idx < N; ++idx)
+              {
+                hashes[idx] = hash_name(names[idx]);
+                ++bucket_begin[bucket_of(hashes[idx]) + 1];
+              }
+            for (size_t b = 0; b < bucket_count; ++b)
+              bucket_begin[b + 1] += bucket_begin[b];
+            // sort the keys into their buckets, dropping repeated names (the first data member of
+            // a given name wins, consistent with data_member_index)
+            std::array<size_t, N> keys = {};
+            std::array<size_t, bucket_count> bucket_size = {};
+            size_t largest_bucket = 0;
+            for (size_t idx = 0; idx < N; ++idx)
+              {
+                const size_t b = bucket_of(hashes[idx]);
+                size_t* const bucket = keys.data() + bucket_begin[b];
+                bool repeated = false;
+                for (size_t i = 0; i < bucket_size[b] and not repeated; ++i)
+                  repeated = hashes[bucket[i]] == hashes[idx] and names[bucket[i]] == names[idx];
+                if (repeated)
+                  continue;
+                bucket[bucket_size[b]++] = idx;
+                if (bucket_size[b] > largest_bucket)
+                  largest_bucket = bucket_size[b];
+                if (names[idx].size() < min_size)
+                  min_size = names[idx].size();
+                if (names[idx].size() > max_size)
+                  max_size = names[idx].size();
+              }
+            // place the largest buckets first
+            for (size_t size = largest_bucket; size > 0; --size)
+              for (size_t b = 0; b < bucket_count; ++b)
+                if (bucket_size[b] == size)
+                  place_bucket(b, keys.data() + bucket_begin[b], size, hashes);
+          }
+
+          consteval void
+          place_bucket(size_t b, const size_t* bucket, size_t size,
+                       const std::array<std::uint64_t, N>& hashes)
+          {
+            for (std::uint32_t seed = 0;; ++seed)
+              {
+                if (seed == std::uint32_t(-1))
+                  throw "no perfect hash found"; // hash collision between two names
+                bool collision = false;
+                for (size_t i = 0; i < size and not collision; ++i)
+                  {
+                    const size_t slot = slot_of(hashes[bucket[i]], seed);
+                    collision = slots[slot] != empty;
+                    for (size_t j = 0; j < i and not collision; ++j)
+                      collision = slot_of(hashes[bucket[j]], seed) == slot;
+                  }
+                if (not collision)
+                  {
+                    seeds[b] = seed;
+                    for (size_t i = 0; i < size; ++i)
+                      slots[slot_of(hashes[bucket[i]], seed)] = bucket[i];
+                    return;
+                  }
+              }
+          }
+
+          // returns size_t(-1) if name is not found
+          constexpr size_t
+          find(std::string_view name) const
+          {
+            if (name.size() < min_size or name.size() > max_size)
+              return size_t(-1);
+            const std::uint64_t hash = hash_name(name);
+            const index_type idx = slots[slot_of(hash, seeds[bucket_of(hash)])];
+            if (idx == empty or names[idx] != name)
+              return size_t(-1);
+            return idx;
+          }
+        };
+
+      template <typename T>
+        constexpr data_member_name_hash<data_member_count<T>> name_hash = data_member_names<T>;
+
+      // One function per data member, calling fun with the (correctly typed) data member of obj.
+      template <typename R, typename Obj, typename Fun>
+        constexpr auto data_member_jump_table = []<size_t... Is>(std::index_sequence<Is...>) {
+          return std::array<R (*)(Obj&, Fun&), sizeof...(Is)> {
+            [](Obj& obj, Fun& fun) -> R { return static_cast<R>(fun(data_member<Is>(obj))); }...
+          };
+        }(std::make_index_sequence<data_member_count<std::remove_const_t<Obj>>>());
+    }
+
+    /**
+     * Calls fun with the data member called name. Returns false (without calling fun) if obj has
+     * no data member with the given name.
+     */
+    constexpr bool
+    visit_data_member(reflectable auto&& obj, std::string_view name, auto&& fun)
+    {
+      using Obj = std::remove_reference_t<decltype(obj)>;
+      using Fun = std::remove_reference_t<decltype(fun)>;
+      using Class = std::remove_cv_t<Obj>;
+      if constexpr (data_member_count<Class> == 0)
+        return false;
+      else
+        {
+          const size_t idx = detail::name_hash<Class>.find(name);
+          if (idx == size_t(-1))
+            return false;
+          detail::data_member_jump_table<void, Obj, Fun>[idx](obj, fun);
+          return true;
+        }
+    }
+
+    /**
+     * Calls fun with the data member at index idx and returns its result. The result type of fun
+     * must be the same for all data members. The behavior is undefined if idx is not less than
+     * data_member_count<T>.
+     */
+    constexpr decltype(auto)
+    visit_data_member(reflectable auto&& obj, size_t idx, auto&& fun)
+    {
+      using Obj = std::remove_reference_t<decltype(obj)>;
+      using Fun = std::remove_reference_t<decltype(fun)>;
+      constexpr size_t count = data_member_count<std::remove_cv_t<Obj>>;
+      static_assert(count > 0, "visit_data_member by index needs at least one data member");
+      using R = decltype(fun(data_member<0>(obj)));
+      static_assert([]<size_t... Is>(std::index_sequence<Is...>) {
+                      return (std::is_same_v<R, decltype(std::declval<Fun&>()(
+                                                          data_member<Is>(std::declval<Obj&>())))>
+                                and ...);
+                    }(std::make_index_sequence<count>()),
+                    "fun must return the same type for every data member");
+      return detail::data_member_jump_table<R, Obj, Fun>[idx](obj, fun);
     }
 
     namespace detail
@@ -431,6 +788,18 @@ namespace vir
     template <reflectable T, detail::data_member_id Id>
       using data_member_type = typename detail::data_member_type_impl<T, Id>::type;
 
+    namespace detail
+    {
+      // The index of a data member given by name or index.
+      template <typename T, data_member_id Id>
+        constexpr size_t member_index = [] {
+          if constexpr (Id.is_name)
+            return data_member_index<T, Id.string()>;
+          else
+            return Id.index;
+        }();
+    }
+
     template <reflectable T, template <typename, size_t> class Pred>
       constexpr std::array find_data_members = []<size_t... Is>(std::index_sequence<Is...>) {
         constexpr size_t matches = (Pred<T, Is>::value + ...);
@@ -506,6 +875,257 @@ namespace vir
           (fun(data_member_descriptor<T, Is>{}), ...);
         }(std::make_index_sequence<data_member_count<T>>());
       }
+
+    namespace detail
+    {
+      constexpr size_t
+      align_up(size_t offset, size_t alignment)
+      { return (offset + alignment - 1) / alignment * alignment; }
+
+      // Offsets and sizes of all data members of T (including base classes), and the offset
+      // behind the last data member. valid is false if the offsets are not known.
+      template <size_t N>
+        struct member_layout
+        {
+          std::array<size_t, N> offsets = {};
+          std::array<size_t, N> sizes = {};
+          size_t end = 0;
+          bool valid = true;
+        };
+
+      // The offsets of the data members of T come from offsetof (see VIR_MAKE_REFLECTABLE),
+      // independent of the order they are listed in and of unlisted data members. Data members of
+      // a reflectable base class B are at their offset in B plus the offset of the B subobject in
+      // T. The latter is not observable in a constant expression. It is known to be 0 if 0 is the
+      // only suitably aligned position for the B subobject in T where the data members of B do
+      // not overlap a data member of T (which may reuse the tail padding of B). Otherwise, and
+      // for polymorphic classes, reference members, static data members, and overlapping
+      // ([[no_unique_address]]) data members, valid is false.
+      template <typename T>
+        consteval auto
+        checked_layout()
+        {
+          using B = base_type<T>;
+          constexpr size_t first = data_member_count<B>;
+          constexpr size_t count = data_member_count<T> - first;
+          member_layout<data_member_count<T>> r;
+          if constexpr (std::is_polymorphic_v<T>
+                          or not requires { T::vir_refl_data_member_offsets(); })
+            r.valid = false;
+          else
+            {
+              constexpr auto own = T::vir_refl_data_member_offsets();
+              [&]<typename... Ms, size_t... Is>(const vir::simple_tuple<Ms...>*,
+                                                std::index_sequence<Is...>) {
+                // reference members have no known size, static data members no offset
+                r.valid = (std::is_object_v<Ms> and ...) and ((own[ic<Is>] != no_offset) and ...);
+                ((r.offsets[first + Is] = own[ic<Is>], r.sizes[first + Is] = sizeof(Ms)), ...);
+              }(static_cast<const typename T::vir_refl_data_member_types*>(nullptr),
+                std::make_index_sequence<count>());
+              // the data members of T in order of their offsets must not overlap
+              std::array<size_t, count> order = {};
+              for (size_t k = 0; k < count; ++k)
+                order[k] = first + k;
+              std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return r.offsets[a] < r.offsets[b];
+              });
+              for (size_t k = 0; k < count; ++k)
+                {
+                  const size_t i = order[k];
+                  r.valid = r.valid and r.offsets[i] >= r.end;
+                  r.end = std::max(r.end, r.offsets[i] + r.sizes[i]);
+                }
+              if constexpr (first != 0)
+                {
+                  // count the positions for the B subobject: aligned, sizeof(B) bytes inside T,
+                  // and no data member of T in its first base.end bytes (the data members of B;
+                  // a data member of T may reuse the tail padding of B behind them)
+                  constexpr auto base = checked_layout<B>();
+                  constexpr size_t last = sizeof(T) - sizeof(B);
+                  size_t candidates = 0;
+                  auto gap = [&](size_t from, size_t to) {
+                    const size_t pos = align_up(from, alignof(B));
+                    if (to >= base.end and pos <= std::min(to - base.end, last))
+                      candidates += (std::min(to - base.end, last) - pos) / alignof(B) + 1;
+                  };
+                  size_t end = 0;
+                  for (size_t k = 0; k < count; ++k)
+                    {
+                      gap(end, r.offsets[order[k]]);
+                      end = std::max(end, r.offsets[order[k]] + r.sizes[order[k]]);
+                    }
+                  gap(end, sizeof(T));
+                  // only the position 0 is accepted, and only if it is the only one
+                  const size_t base_offset = 0;
+                  const size_t own_begin = count == 0 ? sizeof(T) : r.offsets[order[0]];
+                  r.valid = r.valid and base.valid and candidates == 1 and own_begin >= base.end;
+                  for (size_t i = 0; i < first; ++i)
+                    {
+                      r.offsets[i] = base_offset + base.offsets[i];
+                      r.sizes[i] = base.sizes[i];
+                    }
+                  r.end = std::max(r.end, base_offset + base.end);
+                }
+            }
+          return r;
+        }
+
+      template <typename T>
+        constexpr auto layout = [] {
+          static_assert(not std::is_polymorphic_v<T>,
+                        "data member offsets of polymorphic classes are not known");
+          constexpr auto r = checked_layout<T>();
+          static_assert(r.valid,
+                        "data_member_offset / data_member_runs require the offsets of all data "
+                        "members (including those of base classes) to be known");
+          return r;
+        }();
+    }
+
+    template <reflectable T, detail::data_member_id Id>
+      constexpr size_t data_member_offset = [] {
+        if constexpr (Id.is_name)
+          return detail::layout<T>.offsets[data_member_index<T, Id.string()>];
+        else
+          return detail::layout<T>.offsets[Id.index];
+      }();
+
+    // The data members [first, first + count) occupy the bytes [offset, offset + size) of the
+    // object without any padding in between.
+    struct data_member_run
+    {
+      size_t first;
+      size_t count;
+      size_t offset;
+      size_t size;
+
+      friend constexpr bool
+      operator==(data_member_run const&, data_member_run const&) = default;
+    };
+
+    namespace detail
+    {
+      // The maximal runs of consecutive data members with types satisfying Pred and no padding in
+      // between.
+      template <reflectable T, template <typename> class Pred>
+        consteval auto
+        make_runs()
+        {
+          if constexpr (data_member_count<T> == 0)
+            return std::array<data_member_run, 0> {};
+          else
+            {
+              constexpr auto& l = layout<T>;
+              constexpr auto& idxs = find_data_members_by_type<T, Pred>;
+              constexpr auto extends_run = [&](size_t k) {
+                return idxs[k] == idxs[k - 1] + 1
+                         and l.offsets[idxs[k]] == l.offsets[idxs[k - 1]] + l.sizes[idxs[k - 1]];
+              };
+              constexpr size_t n = [&] {
+                size_t count = idxs.size() == 0 ? 0 : 1;
+                for (size_t k = 1; k < idxs.size(); ++k)
+                  count += not extends_run(k);
+                return count;
+              }();
+              std::array<data_member_run, n> runs = {};
+              for (size_t k = 0, r = size_t(-1); k < idxs.size(); ++k)
+                {
+                  if (k == 0 or not extends_run(k))
+                    runs[++r] = {idxs[k], 0, l.offsets[idxs[k]], 0};
+                  ++runs[r].count;
+                  runs[r].size += l.sizes[idxs[k]];
+                }
+              return runs;
+            }
+        }
+
+      template <typename T>
+        consteval bool
+        is_dense_bytewise();
+
+      // The value of T is its object representation, i.e. objects compare equal if and only if
+      // their bytes are equal. For reflectable types this requires that all data members are
+      // bytewise and that they cover all bytes of T.
+      template <typename T>
+        constexpr bool bytewise = [] {
+          if constexpr (not std::has_unique_object_representations_v<T>)
+            return false;
+          else if constexpr (reflectable<T>)
+            return is_dense_bytewise<T>();
+          else
+            return true;
+        }();
+
+      template <typename T>
+        struct is_bytewise
+        : std::bool_constant<bytewise<T>>
+        {};
+
+      template <typename T>
+        consteval bool
+        is_dense_bytewise()
+        {
+          if constexpr (not checked_layout<T>().valid)
+            return false;
+          else
+            {
+              constexpr auto runs = make_runs<T, is_bytewise>();
+              return runs.size() == 1 and runs[0].count == data_member_count<T>
+                       and runs[0].size == sizeof(T);
+            }
+        }
+    }
+
+    // The maximal runs of consecutive trivially copyable data members, i.e. each run can be
+    // copied with a single memcpy.
+    template <reflectable T>
+      constexpr std::array data_member_runs = detail::make_runs<T, std::is_trivially_copyable>();
+
+    namespace detail
+    {
+      // Continues the FNV-1a hash with str and a terminating '\0'.
+      constexpr std::uint64_t
+      fnv1a_field(std::string_view str, std::uint64_t hash)
+      { return fnv1a(std::string_view("", 1), fnv1a(str, hash)); }
+
+      // Continues the hash with the structure of T: the name, type_name, and structure of every
+      // data member if T is reflectable, otherwise the type_name and structure of the element
+      // type (value_type or array element), if any. Outer are the reflectable types currently
+      // being hashed, i.e. a type that (indirectly) contains itself is not expanded again.
+      template <typename T, typename... Outer>
+        constexpr std::uint64_t
+        schema_hash_of(std::uint64_t hash)
+        {
+          if constexpr (reflectable<T>)
+            {
+              if constexpr (not (std::is_same_v<T, Outer> or ...))
+                {
+                  [&]<size_t... Is>(std::index_sequence<Is...>) {
+                    ((hash = schema_hash_of<data_member_type<T, Is>, T, Outer...>(
+                               fnv1a_field(type_name<data_member_type<T, Is>>.view(),
+                                           fnv1a_field(data_member_name<T, Is>.view(), hash)))),
+                     ...);
+                  }(std::make_index_sequence<data_member_count<T>>());
+                }
+              return fnv1a_field({}, hash);
+            }
+          else if constexpr (std::is_array_v<T>)
+            return schema_hash_of<std::remove_extent_t<T>, Outer...>(
+                     fnv1a_field(type_name<std::remove_extent_t<T>>.view(), hash));
+          else if constexpr (requires { typename T::value_type; })
+            return schema_hash_of<typename T::value_type, Outer...>(
+                     fnv1a_field(type_name<typename T::value_type>.view(), hash));
+          else
+            return hash;
+        }
+    }
+
+    // A 64-bit fingerprint of the schema of T: class_name<T> and, in index order, the name and
+    // type_name of every data member (including those of base classes), where the data members
+    // of reflectable data member types (and element types) are included recursively.
+    template <reflectable T>
+      constexpr std::uint64_t schema_hash
+        = detail::schema_hash_of<T>(detail::fnv1a_field(class_name<T>.view(), detail::fnv1a({})));
   }
 }
 
@@ -15,102 +15,78 @@ namespace vir
     template <auto X>
       inline constexpr std::integral_constant<std::remove_const_t<decltype(X)>, X> ic {};
 
-#define VIR_SIMPLE_TUPLE_DATA_COMPARES                         \
-  friend constexpr bool                                        \
-  operator==(tuple_data const&, tuple_data const&) = default;  \
-                                                               \
-  friend constexpr auto                                        \
-  operator<=>(tuple_data const&, tuple_data const&) = default
-
-#define VIR_SIMPLE_TUPLE_DATA_IMPL(i)                          \
-  T##i value##i;                                               \
-                                                               \
-  template <size_t Idx>                                        \
-    requires (Idx == Off + i)                                  \
-    friend constexpr T##i&&                                    \
-    get(tuple_data&& obj) noexcept                             \
-    { return static_cast<T##i&&>(obj.value##i); }              \
-                                                               \
-  template <size_t Idx>                                        \
-    requires (Idx == Off + i)                                  \
-    friend constexpr T##i&                                     \
-    get(tuple_data& obj) noexcept                              \
-    { return obj.value##i; }                                   \
-                                                               \
-  template <size_t Idx>                                        \
-    requires (Idx == Off + i)                                  \
-    friend constexpr T##i const&                               \
-    get(tuple_data const& obj) noexcept                        \
-    { return obj.value##i; }                                   \
-                                                               \
-  template <typename Idx>                                      \
-    requires (Idx::value == Off + i)                           \
-    friend consteval T##i                                      \
-    type_at_impl_(tuple_data const&, Idx)                      \
-    { return std::declval<T##i>(); }
-
-    template <int Off, typename... Ts>
-      struct tuple_data;
+    // Every element is stored in its own leaf, distinguished by its index. All leaves are direct
+    // bases of tuple_data. Therefore, the nesting depth is constant and get<Idx> only needs to
+    // deduce the unique base tuple_leaf<Idx, T> instead of resolving an overload set that grows
+    // with the tuple size.
+    template <size_t Idx, typename T>
+      struct tuple_leaf
+      {
+        T value;
 
-    template <>
-      struct tuple_data<0>
-      { VIR_SIMPLE_TUPLE_DATA_COMPARES; };
+        friend constexpr bool
+        operator==(tuple_leaf const&, tuple_leaf const&) = default;
 
-    template <int Off, typename T0>
-      struct tuple_data<Off, T0>
-      {
-        VIR_SIMPLE_TUPLE_DATA_IMPL(0)
-        VIR_SIMPLE_TUPLE_DATA_COMPARES;
+        friend constexpr auto
+        operator<=>(tuple_leaf const&, tuple_leaf const&) = default;
       };
 
-    template <int Off, typename T0, typename T1>
-      struct tuple_data<Off, T0, T1>
-      {
-        VIR_SIMPLE_TUPLE_DATA_IMPL(0)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(1)
-        VIR_SIMPLE_TUPLE_DATA_COMPARES;
-      };
+    template <size_t Idx, typename T>
+      constexpr T&&
+      get(tuple_leaf<Idx, T>&& obj) noexcept
+      { return static_cast<T&&>(obj.value); }
 
-    template <int Off, typename T0, typename T1, typename T2>
-      struct tuple_data<Off, T0, T1, T2>
-      {
-        VIR_SIMPLE_TUPLE_DATA_IMPL(0)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(1)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(2)
-        VIR_SIMPLE_TUPLE_DATA_COMPARES;
-      };
+    template <size_t Idx, typename T>
+      constexpr T&
+      get(tuple_leaf<Idx, T>& obj) noexcept
+      { return obj.value; }
 
-    template <int Off, typename T0, typename T1, typename T2, typename T3>
-      struct tuple_data <Off, T0, T1, T2, T3>
+    template <size_t Idx, typename T>
+      constexpr T const&
+      get(tuple_leaf<Idx, T> const& obj) noexcept
+      { return obj.value; }
+
+    template <size_t Idx, typename T>
+      std::type_identity<T>
+      type_at_impl(tuple_leaf<Idx, T> const&); // not defined
+
+    template <typename Seq, typename... Ts>
+      struct tuple_data;
+
+    template <size_t... Is, typename... Ts>
+      struct tuple_data<std::index_sequence<Is...>, Ts...>
+      : tuple_leaf<Is, Ts>...
       {
-        VIR_SIMPLE_TUPLE_DATA_IMPL(0)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(1)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(2)
-        VIR_SIMPLE_TUPLE_DATA_IMPL(3)
-        VIR_SIMPLE_TUPLE_DATA_COMPARES;
+        friend constexpr bool
+        operator==(tuple_data const&, tuple_data const&) = default;
+
+        friend constexpr auto
+        operator<=>(tuple_data const&, tuple_data const&) = default;
       };
 
-    template <int Off, typename T0, typename T1, typename T2, typename T3, typename... More>
-      requires (sizeof...(More) > 0) and (sizeof...(More) <= 4)
-      struct tuple_data<Off, T0, T1, T2, T3, More...>
-      : tuple_data<Off, T0, T1, T2, T3>, tuple_data<Off + 4, More...>
-      { VIR_SIMPLE_TUPLE_DATA_COMPARES; };
-
-    template <int Off, typename T0, typename T1, typename T2, typename T3,
-              typename T4, typename T5, typename T6, typename T7, typename... More>
-      requires (sizeof...(More) > 0)
-      struct tuple_data<Off, T0, T1, T2, T3, T4, T5, T6, T7, More...>
-      : tuple_data<Off, T0, T1, T2, T3>, tuple_data<Off + 4, T4, T5, T6, T7>,
-        tuple_data<Off + 8, More...>
-      { VIR_SIMPLE_TUPLE_DATA_COMPARES; };
-
-#undef VIR_SIMPLE_TUPLE_DATA_IMPL
-#undef VIR_SIMPLE_TUPLE_DATA_COMPARES
+#if defined __has_builtin
+#if __has_builtin(__type_pack_element)
+#define VIR_HAVE_TYPE_PACK_ELEMENT 1
+#endif
+#endif
+
+    template <size_t Idx, typename... Ts>
+      struct type_at
+#ifdef VIR_HAVE_TYPE_PACK_ELEMENT
+      { using type = __type_pack_element<Idx, Ts...>; };
+#undef VIR_HAVE_TYPE_PACK_ELEMENT
+#else
+      : decltype(type_at_impl<Idx>(
+                   std::declval<tuple_data<std::index_sequence_for<Ts...>, Ts...> const&>()))
+      {};
+#endif
   }
 
   template <typename... Ts>
-    class simple_tuple : public detail::tuple_data<0, Ts...>
+    class simple_tuple : public detail::tuple_data<std::index_sequence_for<Ts...>, Ts...>
     {
+      using data_type = detail::tuple_data<std::index_sequence_for<Ts...>, Ts...>;
+
     public:
       static constexpr auto size = detail::ic<sizeof...(Ts)>;
 
@@ -122,7 +98,7 @@ namespace vir
         requires (sizeof...(Ts) == sizeof...(Us)) and (std::convertible_to<Us&&, Ts> and ...)
         constexpr
         simple_tuple(Us&&... init)
-        : detail::tuple_data<0, Ts...> {static_cast<Us&&>(init)...}
+        : data_type {static_cast<Us&&>(init)...}
         {}
 #pragma GCC diagnostic pop
 
@@ -155,8 +131,7 @@ namespace vir
 
       template <size_t Idx>
         requires (Idx < sizeof...(Ts))
-        using type_at = decltype(type_at_impl_(std::declval<detail::tuple_data<0, Ts...>>(),
-                                               detail::ic<Idx>));
+        using type_at = typename detail::type_at<Idx, Ts...>::type;
 
       friend constexpr bool
       operator==(simple_tuple const&, simple_tuple const&) = default;
@@ -0,0 +1,511 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_SOA_VECTOR_H_
+#define VIR_SOA_VECTOR_H_
+
+#include "reflect-light.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    template <typename T, typename = std::make_index_sequence<data_member_count<T>>>
+      struct soa_types;
+
+    template <typename T, size_t... Is>
+      struct soa_types<T, std::index_sequence<Is...>>
+      {
+        using members = vir::simple_tuple<data_member_type<T, Is>...>;
+        using pointers = vir::simple_tuple<data_member_type<T, Is>*...>;
+        using references = vir::simple_tuple<data_member_type<T, Is>&...>;
+        using const_references = vir::simple_tuple<const data_member_type<T, Is>&...>;
+
+        static constexpr vir::simple_tuple names {data_member_name<T, Is>...};
+      };
+
+    template <typename T>
+      using soa_pointers = typename soa_types<T>::pointers;
+  }
+
+  // A reference to the element of a soa_vector<T>. It is reflectable with the same data members
+  // (names and types) as T, flattening the base classes of T. Thus, data_member<Name>(ref) and
+  // all other facilities of this library work on the element.
+  template <reflectable T, bool Const = false>
+    class soa_reference
+    {
+      using pointers = detail::soa_pointers<T>;
+
+      const pointers* columns_;
+      size_t index_;
+
+    public:
+      using value_type = T;
+
+      using vir_refl_explicit_base = detail::explicit_base<soa_reference, void>;
+
+      using vir_refl_data_member_types = typename detail::soa_types<T>::members;
+
+      static constexpr std::integral_constant<size_t, data_member_count<T>>
+        vir_refl_data_member_count {};
+
+      static constexpr auto vir_refl_data_member_names = detail::soa_types<T>::names;
+
+      constexpr
+      soa_reference(const pointers& columns, size_t index)
+      : columns_(&columns), index_(index)
+      {}
+
+      // a reference can be converted to a const reference
+      constexpr
+      operator soa_reference<T, true>() const requires (not Const)
+      { return {*columns_, index_}; }
+
+      constexpr auto
+      vir_refl_members_as_tuple() const
+      {
+        using R = std::conditional_t<Const, typename detail::soa_types<T>::const_references,
+                                     typename detail::soa_types<T>::references>;
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+          return R {(*columns_)[detail::ic<Is>][index_]...};
+        }(std::make_index_sequence<data_member_count<T>>());
+      }
+
+      // Returns a copy of the element.
+      constexpr
+      operator T() const
+      {
+        T obj {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(obj) = data_member<Is>(*this)), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return obj;
+      }
+
+      // Assigns all data members of obj to the element.
+      constexpr const soa_reference&
+      operator=(const T& obj) const requires (not Const)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(*this) = data_member<Is>(obj)), ...);
+        }(std::make_index_sequence<data_member_count<T>>());
+        return *this;
+      }
+    };
+
+  // A sequence container of T objects, which stores every data member of T (including those of
+  // base classes) in its own contiguous array ("column"). All columns share a single allocation.
+  template <reflectable T>
+    class soa_vector
+    {
+      static constexpr size_t N = data_member_count<T>;
+
+      static_assert(N != 0, "soa_vector<T> requires T to have data members");
+
+      static_assert([]<size_t... Is>(std::index_sequence<Is...>) {
+                      return (not std::is_array_v<data_member_type<T, Is>> and ...);
+                    }(std::make_index_sequence<N>()),
+                    "soa_vector<T> does not support array data members; use std::array");
+
+      static constexpr auto indexes = std::make_index_sequence<N>();
+
+      template <size_t Idx>
+        using column_type = data_member_type<T, Idx>;
+
+      static constexpr size_t alignment = [] {
+        size_t a = alignof(std::max_align_t);
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((a = a < alignof(column_type<Is>) ? alignof(column_type<Is>) : a), ...);
+        }(indexes);
+        return a;
+      }();
+
+      detail::soa_pointers<T> columns_ = {};
+      size_t size_ = 0;
+      size_t capacity_ = 0;
+
+      // The column pointers for a block of the given capacity starting at memory.
+      static constexpr detail::soa_pointers<T>
+      layout(std::byte* memory, size_t capacity)
+      {
+        size_t offset = 0;
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+          return detail::soa_pointers<T> {[&] {
+            offset = detail::align_up(offset, alignof(column_type<Is>));
+            auto* column = reinterpret_cast<column_type<Is>*>(memory + offset);
+            offset += capacity * sizeof(column_type<Is>);
+            return column;
+          }()...};
+        }(indexes);
+      }
+
+      static constexpr size_t
+      bytes_for(size_t capacity)
+      {
+        size_t bytes = 0;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((bytes = detail::align_up(bytes, alignof(column_type<Is>))
+                      + capacity * sizeof(column_type<Is>)), ...);
+        }(indexes);
+        return bytes;
+      }
+
+      // The start of the allocation is the start of the first column.
+      std::byte*
+      memory() const
+      {
+        if constexpr (N == 0)
+          return nullptr;
+        else
+          return reinterpret_cast<std::byte*>(columns_[detail::ic<0>]);
+      }
+
+      void
+      deallocate()
+      {
+        if (capacity_ != 0)
+          ::operator delete(memory(), std::align_val_t(alignment));
+      }
+
+      void
+      destroy_range(size_t first, size_t last)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          (std::destroy(columns_[detail::ic<Is>] + first, columns_[detail::ic<Is>] + last), ...);
+        }(indexes);
+      }
+
+      // Destroys the elements [first, last) of the columns [0, constructed) on destruction,
+      // unless dismissed. I.e. if constructing one column throws, the elements constructed in the
+      // columns before are destroyed.
+      struct construction_guard
+      {
+        const detail::soa_pointers<T>& columns;
+        size_t first;
+        size_t last;
+        size_t constructed = 0;
+
+        ~construction_guard()
+        {
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((Is < constructed ? void(std::destroy(columns[detail::ic<Is>] + first,
+                                                   columns[detail::ic<Is>] + last))
+                               : void()), ...);
+          }(indexes);
+        }
+      };
+
+      // Deallocates a block that was allocated for (but not yet assigned to) columns_ on
+      // destruction, unless dismissed.
+      struct allocation_guard
+      {
+        std::byte* memory;
+
+        ~allocation_guard()
+        {
+          if (memory != nullptr)
+            ::operator delete(memory, std::align_val_t(alignment));
+        }
+      };
+
+      // reserve moves the elements to the new block only if no move constructor can throw (or if
+      // a column cannot be copied). Otherwise it copies them, thus a throwing reserve leaves
+      // *this unchanged (as std::vector does).
+      static constexpr bool move_on_reserve = []<size_t... Is>(std::index_sequence<Is...>) {
+        return (std::is_nothrow_move_constructible_v<column_type<Is>> and ...)
+                 or not (std::is_copy_constructible_v<column_type<Is>> and ...);
+      }(indexes);
+
+      template <typename Obj>
+        void
+        construct_back(Obj&& obj)
+        {
+          construction_guard guard {columns_, size_, size_ + 1};
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((std::construct_at(columns_[detail::ic<Is>] + size_, [&]() -> decltype(auto) {
+                if constexpr (std::is_lvalue_reference_v<Obj>)
+                  return data_member<Is>(obj);
+                else
+                  return std::move(data_member<Is>(obj));
+              }()), ++guard.constructed), ...);
+          }(indexes);
+          guard.constructed = 0;
+          ++size_;
+        }
+
+      template <typename Obj>
+        void
+        grow_and_construct_back(Obj&& obj)
+        {
+          if (size_ == capacity_)
+            reserve(capacity_ == 0 ? 8 : 2 * capacity_);
+          construct_back(static_cast<Obj&&>(obj));
+        }
+
+    public:
+      using value_type = T;
+      using size_type = size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference = soa_reference<T>;
+      using const_reference = soa_reference<T, true>;
+
+      template <bool Const>
+        class basic_iterator
+        {
+          const detail::soa_pointers<T>* columns_ = nullptr;
+          size_t index_ = 0;
+
+          friend soa_vector;
+
+          constexpr
+          basic_iterator(const detail::soa_pointers<T>& columns, size_t index)
+          : columns_(&columns), index_(index)
+          {}
+
+        public:
+          using value_type = T;
+          using difference_type = std::ptrdiff_t;
+          using reference = soa_reference<T, Const>;
+          using iterator_category = std::input_iterator_tag;
+
+          constexpr
+          basic_iterator() = default;
+
+          constexpr reference
+          operator*() const
+          { return {*columns_, index_}; }
+
+          constexpr basic_iterator&
+          operator++()
+          {
+            ++index_;
+            return *this;
+          }
+
+          constexpr basic_iterator
+          operator++(int)
+          { return {*columns_, index_++}; }
+
+          friend constexpr bool
+          operator==(const basic_iterator&, const basic_iterator&) = default;
+        };
+
+      using iterator = basic_iterator<false>;
+      using const_iterator = basic_iterator<true>;
+
+      soa_vector() = default;
+
+      explicit
+      soa_vector(size_t n)
+      { resize(n); }
+
+      soa_vector(const soa_vector& other)
+      {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+          push_back(other[i]);
+      }
+
+      soa_vector(soa_vector&& other) noexcept
+      : columns_(std::exchange(other.columns_, {})), size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0))
+      {}
+
+      soa_vector&
+      operator=(const soa_vector& other)
+      {
+        if (this != &other)
+          {
+            soa_vector copy(other);
+            swap(copy);
+          }
+        return *this;
+      }
+
+      soa_vector&
+      operator=(soa_vector&& other) noexcept
+      {
+        soa_vector moved(std::move(other));
+        swap(moved);
+        return *this;
+      }
+
+      ~soa_vector()
+      {
+        clear();
+        deallocate();
+      }
+
+      void
+      swap(soa_vector& other) noexcept
+      {
+        std::swap(columns_, other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+      }
+
+      // capacity
+      size_t
+      size() const
+      { return size_; }
+
+      size_t
+      capacity() const
+      { return capacity_; }
+
+      bool
+      empty() const
+      { return size_ == 0; }
+
+      // Allocates memory for all columns in one block, if n exceeds capacity(). If moving or
+      // copying an element throws, *this is unchanged (see move_on_reserve).
+      void
+      reserve(size_t n)
+      {
+        if (n <= capacity_)
+          return;
+        allocation_guard allocation {static_cast<std::byte*>(
+                                       ::operator new(bytes_for(n), std::align_val_t(alignment)))};
+        const detail::soa_pointers<T> columns = layout(allocation.memory, n);
+        construction_guard guard {columns, 0, size_};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((move_on_reserve
+              ? void(std::uninitialized_move_n(columns_[detail::ic<Is>], size_,
+                                               columns[detail::ic<Is>]))
+              : void(std::uninitialized_copy_n(columns_[detail::ic<Is>], size_,
+                                               columns[detail::ic<Is>])),
+            ++guard.constructed), ...);
+        }(indexes);
+        guard.constructed = 0;
+        allocation.memory = nullptr;
+        destroy_range(0, size_);
+        deallocate();
+        columns_ = columns;
+        capacity_ = n;
+      }
+
+      // Value-initializes new elements or destroys the elements at the end. If value-initializing
+      // a data member throws, the size is unchanged.
+      void
+      resize(size_t n)
+      {
+        if (n < size_)
+          {
+            destroy_range(n, size_);
+            size_ = n;
+            return;
+          }
+        reserve(n);
+        construction_guard guard {columns_, size_, n};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((std::uninitialized_value_construct(columns_[detail::ic<Is>] + size_,
+                                               columns_[detail::ic<Is>] + n),
+            ++guard.constructed), ...);
+        }(indexes);
+        guard.constructed = 0;
+        size_ = n;
+      }
+
+      void
+      clear()
+      {
+        destroy_range(0, size_);
+        size_ = 0;
+      }
+
+      // modifiers
+      void
+      push_back(const T& obj)
+      { grow_and_construct_back(obj); }
+
+      void
+      push_back(T&& obj)
+      { grow_and_construct_back(std::move(obj)); }
+
+      // obj may reference an element of *this, which reserve moves. Thus, copy it first if the
+      // storage grows.
+      void
+      push_back(const_reference obj)
+      {
+        if (size_ == capacity_)
+          grow_and_construct_back(T(obj));
+        else
+          construct_back(obj);
+      }
+
+      void
+      push_back(reference obj)
+      { push_back(const_reference(obj)); }
+
+      void
+      pop_back()
+      {
+        --size_;
+        destroy_range(size_, size_ + 1);
+      }
+
+      // element access
+      reference
+      operator[](size_t i)
+      { return {columns_, i}; }
+
+      const_reference
+      operator[](size_t i) const
+      { return {columns_, i}; }
+
+      reference
+      front()
+      { return (*this)[0]; }
+
+      const_reference
+      front() const
+      { return (*this)[0]; }
+
+      reference
+      back()
+      { return (*this)[size_ - 1]; }
+
+      const_reference
+      back() const
+      { return (*this)[size_ - 1]; }
+
+      iterator
+      begin()
+      { return {columns_, 0}; }
+
+      iterator
+      end()
+      { return {columns_, size_}; }
+
+      const_iterator
+      begin() const
+      { return {columns_, 0}; }
+
+      const_iterator
+      end() const
+      { return {columns_, size_}; }
+
+      // The contiguous array of the data member given by index or name, e.g. column<"x">().
+      template <detail::data_member_id Id>
+        std::span<column_type<detail::member_index<T, Id>>>
+        column()
+        { return {columns_[detail::ic<detail::member_index<T, Id>>], size_}; }
+
+      template <detail::data_member_id Id>
+        std::span<const column_type<detail::member_index<T, Id>>>
+        column() const
+        { return {columns_[detail::ic<detail::member_index<T, Id>>], size_}; }
+    };
+}
+
+#endif  // VIR_SOA_VECTOR_H_
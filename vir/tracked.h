@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_TRACKED_H_
+#define VIR_TRACKED_H_
+
+#include "reflect-light-delta.h"
+
+#include <bitset>
+#include <memory>
+#include <utility>
+
+namespace vir::refl
+{
+  // A T together with one dirty bit per data member (including those of base classes), stored
+  // inline. The write accessors set<Id>(value) and data_member<Id>() set the bit of the data
+  // member; reading via value() does not. for_each_dirty visits the data members with a set bit,
+  // clear_dirty resets all bits.
+  template <reflectable T>
+    class tracked
+    {
+      static constexpr size_t N = data_member_count<T>;
+
+      T value_ {};
+      detail::delta_mask<T> dirty_ = {};
+
+      template <size_t Idx>
+        constexpr void
+        mark()
+        { dirty_[Idx / 64] |= std::uint64_t(1) << (Idx % 64); }
+
+    public:
+      using value_type = T;
+
+      tracked() = default;
+
+      // Starts with all dirty bits cleared.
+      constexpr explicit
+      tracked(const T& value)
+      : value_(value)
+      {}
+
+      constexpr explicit
+      tracked(T&& value)
+      : value_(std::move(value))
+      {}
+
+      constexpr const T&
+      value() const
+      { return value_; }
+
+      constexpr const T&
+      operator*() const
+      { return value_; }
+
+      constexpr const T*
+      operator->() const
+      { return std::addressof(value_); }
+
+      // Assigns value to the data member given by index or name, e.g. set<"gain">(2.f), and marks
+      // it dirty (also if the value does not change).
+      template <detail::data_member_id Id, typename U>
+        constexpr void
+        set(U&& value)
+        {
+          constexpr size_t Idx = detail::member_index<T, Id>;
+          vir::refl::data_member<Idx>(value_) = std::forward<U>(value);
+          mark<Idx>();
+        }
+
+      // Marks the data member given by index or name dirty and returns a reference to it for
+      // writing.
+      template <detail::data_member_id Id>
+        constexpr data_member_type<T, detail::member_index<T, Id>>&
+        data_member()
+        {
+          constexpr size_t Idx = detail::member_index<T, Id>;
+          mark<Idx>();
+          return vir::refl::data_member<Idx>(value_);
+        }
+
+      // Assigns value and marks the data members that differ (see diff).
+      constexpr void
+      assign(const T& value)
+      {
+        const detail::delta_mask<T> changed = detail::diff_mask(value_, value);
+        value_ = value;
+        for (size_t w = 0; w < dirty_.size(); ++w)
+          dirty_[w] |= changed[w];
+      }
+
+      template <detail::data_member_id Id>
+        constexpr bool
+        is_dirty() const
+        {
+          constexpr size_t Idx = detail::member_index<T, Id>;
+          return (dirty_[Idx / 64] >> (Idx % 64)) & 1;
+        }
+
+      constexpr bool
+      any_dirty() const
+      {
+        for (std::uint64_t word : dirty_)
+          if (word != 0)
+            return true;
+        return false;
+      }
+
+      // The dirty bits, e.g. for serialize_delta(t.value(), t.dirty(), buffer).
+      std::bitset<N>
+      dirty() const
+      { return detail::to_bitset<T>(dirty_); }
+
+      // Calls fun(std::integral_constant<size_t, Idx>(), data_member<Idx>(value())) for every
+      // dirty data member, in index order. The data member is accessed like in the delta encoding,
+      // i.e. via its offset only if the offsets of T are known (see detail::delta_member).
+      template <typename Fun>
+        constexpr void
+        for_each_dirty(Fun&& fun) const
+        {
+          if constexpr (N != 0)
+            {
+              auto visit = [&](auto idx, const auto& member) {
+                fun(idx, member);
+                return true;
+              };
+              detail::for_each_set_bit(dirty_, [&](size_t idx) {
+                return detail::delta_jump_table<const T, decltype(visit)>[idx](value_, visit);
+              });
+            }
+        }
+
+      constexpr void
+      clear_dirty()
+      { dirty_ = {}; }
+    };
+}
+
+#endif  // VIR_TRACKED_H_
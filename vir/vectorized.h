@@ -0,0 +1,182 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/* Copyright © 2024      GSI Helmholtzzentrum fuer Schwerionenforschung GmbH
+ *                       Matthias Kretz <m.kretz@gsi.de>
+ */
+
+#ifndef VIR_VECTORIZED_H_
+#define VIR_VECTORIZED_H_
+
+#include "aosoa_vector.h"
+
+// vectorized<T, N> requires <experimental/simd> (Parallelism TS 2). Without it, the header
+// declares nothing and VIR_HAVE_VECTORIZED is not defined.
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+#ifdef __cpp_lib_experimental_parallel_simd
+#define VIR_HAVE_VECTORIZED 1
+
+namespace vir::refl
+{
+  namespace detail
+  {
+    // The SIMD type with N elements of type U (the native ABI if it has N elements).
+    template <typename U, size_t N>
+      using simd_of
+        = std::experimental::simd<U, std::experimental::simd_abi::deduce_t<U, N>>;
+
+    template <typename T, size_t N, typename = std::make_index_sequence<data_member_count<T>>>
+      struct vectorized_types;
+
+    template <typename T, size_t N, size_t... Is>
+      struct vectorized_types<T, N, std::index_sequence<Is...>>
+      {
+        using members = vir::simple_tuple<simd_of<data_member_type<T, Is>, N>...>;
+        using references = vir::simple_tuple<simd_of<data_member_type<T, Is>, N>&...>;
+        using const_references
+          = vir::simple_tuple<const simd_of<data_member_type<T, Is>, N>&...>;
+      };
+  }
+
+  // A reflectable type with the same data members (names, indexes) as T (flattening the base
+  // classes of T), where every data member is a SIMD vector of N values of the data member type
+  // of T. Thus, a kernel written against data_member<Name>(obj) processes one T or N T objects at
+  // once. N defaults to the tile width of aosoa_vector<T>.
+  template <reflectable T, size_t N = detail::native_tile_width<T>>
+    class vectorized
+    {
+      static constexpr auto indexes = std::make_index_sequence<data_member_count<T>>();
+
+      static_assert([]<size_t... Is>(std::index_sequence<Is...>) {
+                      return ((std::is_arithmetic_v<data_member_type<T, Is>>
+                                 and not std::is_same_v<data_member_type<T, Is>, bool>) and ...);
+                    }(indexes),
+                    "vectorized<T> requires all data members of T to be of arithmetic type "
+                    "(except bool)");
+
+      typename detail::vectorized_types<T, N>::members data_;
+
+      template <size_t Idx>
+        using member_type = data_member_type<T, Idx>;
+
+    public:
+      using value_type = T;
+
+      static constexpr std::integral_constant<size_t, N> size {};
+
+      using vir_refl_explicit_base = detail::explicit_base<vectorized, void>;
+
+      using vir_refl_data_member_types = typename detail::vectorized_types<T, N>::members;
+
+      static constexpr std::integral_constant<size_t, data_member_count<T>>
+        vir_refl_data_member_count {};
+
+      static constexpr auto vir_refl_data_member_names = detail::soa_types<T>::names;
+
+      auto
+      vir_refl_members_as_tuple() &
+      {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+          return typename detail::vectorized_types<T, N>::references {data_[detail::ic<Is>]...};
+        }(indexes);
+      }
+
+      auto
+      vir_refl_members_as_tuple() const&
+      {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+          return typename detail::vectorized_types<T, N>::const_references {
+                   data_[detail::ic<Is>]...};
+        }(indexes);
+      }
+
+      vectorized() = default;
+
+      // Broadcasts obj to all N elements.
+      explicit
+      vectorized(const T& obj)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_[detail::ic<Is>] = data_member<Is>(obj)), ...);
+        }(indexes);
+      }
+
+      // Loads the N objects at ptr (array of structures).
+      explicit
+      vectorized(const T* ptr)
+      { copy_from(ptr); }
+
+      void
+      copy_from(const T* ptr)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_[detail::ic<Is>] = detail::simd_of<member_type<Is>, N>([&](auto i) {
+             return data_member<Is>(ptr[i]);
+           })), ...);
+        }(indexes);
+      }
+
+      void
+      copy_to(T* ptr) const
+      {
+        for (size_t i = 0; i < N; ++i)
+          [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((data_member<Is>(ptr[i]) = data_[detail::ic<Is>][i]), ...);
+          }(indexes);
+      }
+
+      // Loads the elements [first, first + N) of v from its columns (structure of arrays).
+      void
+      copy_from(const soa_vector<T>& v, size_t first)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          (data_[detail::ic<Is>].copy_from(v.template column<Is>().data() + first,
+                                           std::experimental::element_aligned), ...);
+        }(indexes);
+      }
+
+      void
+      copy_to(soa_vector<T>& v, size_t first) const
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          (data_[detail::ic<Is>].copy_to(v.template column<Is>().data() + first,
+                                         std::experimental::element_aligned), ...);
+        }(indexes);
+      }
+
+      // Loads tile t of v. Requires a full tile, i.e. (t + 1) * N <= v.size().
+      void
+      copy_from(const aosoa_vector<T, N>& v, size_t t)
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          (data_[detail::ic<Is>].copy_from(v.template column<Is>(t).data(),
+                                           std::experimental::element_aligned), ...);
+        }(indexes);
+      }
+
+      void
+      copy_to(aosoa_vector<T, N>& v, size_t t) const
+      {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          (data_[detail::ic<Is>].copy_to(v.template column<Is>(t).data(),
+                                         std::experimental::element_aligned), ...);
+        }(indexes);
+      }
+
+      // Returns a copy of the element at index i < N.
+      T
+      operator[](size_t i) const
+      {
+        T obj {};
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((data_member<Is>(obj) = data_[detail::ic<Is>][i]), ...);
+        }(indexes);
+        return obj;
+      }
+    };
+}
+
+#endif  // __cpp_lib_experimental_parallel_simd
+
+#endif  // VIR_VECTORIZED_H_